@@ -0,0 +1,1364 @@
+// -----------------------------
+// projects/graph/BenchGraph.c++
+// Copyright (C) 2013
+// Glenn P. Downing
+// -----------------------------
+
+/*
+To run the benchmarks:
+    g++ -pedantic -std=c++14 -Wall -O3 BenchGraph.c++ -o BenchGraph -lbenchmark -pthread
+    ./BenchGraph
+    ./BenchGraph --benchmark_out=BenchGraph.json --benchmark_out_format=json
+
+The inputs go from 10^3 edges up to BENCH_GRAPH_MAX_EDGES edges (environment
+variable, 10^6 by default). The full suite goes to 10^7, which needs several GB
+for the boost graphs alone: 'make -f makefile.c++ BenchGraphFull.json' runs it.
+Every benchmark of the Graph free functions and algorithms runs on Graph, on the
+other basic_graph storage selectors and on boost::adjacency_list<setS, vecS, directedS>,
+with the same inputs. The footprint benchmarks report the heap bytes per edge.
+
+BenchGraphStats is the same program built with -DGRAPH_STATS (see GraphStats.h); running
+both with the same --benchmark_filter shows what the instrumentation costs, and the
+graph_stats line of the context says which of the two produced a report.
+*/
+
+// --------
+// includes
+// --------
+
+#include <atomic>   // atomic
+#include <chrono>   // duration, steady_clock
+#include <cmath>    // pow, sqrt
+#include <cstddef>  // size_t
+#include <cstdio>   // remove
+#include <cstdlib>  // free, getenv, malloc, strtoull
+#include <cstring>  // memset
+#include <fstream>  // ifstream, ofstream
+#include <iterator> // back_inserter
+#include <mutex>    // lock_guard, mutex
+#include <new>      // bad_alloc
+#include <random>   // mt19937_64, uniform_int_distribution, uniform_real_distribution
+#include <string>   // string
+#include <thread>   // thread
+#include <utility>  // make_pair, pair
+#include <vector>   // vector
+
+#include <linux/perf_event.h> // perf_event_attr
+#include <malloc.h>             // malloc_usable_size
+#include <sys/ioctl.h>          // ioctl
+#include <sys/syscall.h>        // SYS_perf_event_open
+#include <unistd.h>             // close, read, syscall
+
+//boost's adjacency_list copy (copy_impl) trips -Wmaybe-uninitialized at -O3 on its own edge iterators
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include "boost/graph/adjacency_list.hpp"    // adjacency_list
+#include "boost/graph/strong_components.hpp" // strong_components
+#pragma GCC diagnostic pop
+
+#include "benchmark/benchmark.h" // google benchmark
+
+#include "Graph.h"
+#include "GraphArena.h"
+#include "GraphCompressed.h"
+#include "GraphConcurrent.h"
+#include "GraphFile.h"
+#include "GraphLoader.h"
+
+typedef boost::adjacency_list<boost::setS, boost::vecS, boost::directedS> BoostGraph;
+typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS> BoostVecGraph; //boost's remove_vertex breaks setS rows
+typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::bidirectionalS> BoostBidirectionalGraph;
+
+typedef basic_graph<vectorS, vectorS> VectorGraph;
+typedef basic_graph<small_vectorS<4>, vectorS> SmallVectorGraph;
+typedef basic_graph<vectorS, vectorS, boost::bidirectionalS> BidirectionalGraph;
+typedef basic_graph<dequeS, dequeS, boost::directedS, ArenaAllocator<std::size_t> > ArenaGraph;
+typedef basic_graph<vectorS, vectorS, boost::directedS, ArenaAllocator<std::size_t> > ArenaVectorGraph;
+typedef basic_graph<small_vectorS<4>, vectorS, boost::directedS, ArenaAllocator<std::size_t> > ArenaSmallVectorGraph;
+
+typedef std::vector< std::pair<std::size_t, std::size_t> > EdgeList;
+
+// ----------------
+// heap accounting
+// ----------------
+
+/*
+Every operator new in the program goes through malloc here, so that the heap held by a graph
+(what malloc actually handed out, rounding included) and the number of allocations can be read
+around its construction.
+*/
+
+std::atomic<long> heap_bytes(0);       /*!< bytes currently allocated */
+std::atomic<long> heap_allocations(0); /*!< allocations so far */
+
+void* operator new (std::size_t n)
+{
+    void* p = std::malloc(n == 0 ? 1 : n);
+    if(p == 0)
+    {
+        throw std::bad_alloc();
+    }
+    heap_bytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+void operator delete (void* p) noexcept
+{
+    if(p != 0)
+    {
+        heap_bytes.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+// ------------
+// cache misses
+// ------------
+
+/**
+ * the cache misses of the calling thread from the time it is constructed, through perf_event_open
+ * most virtual machines expose no hardware counters, available() is false there and the benchmarks
+ * that use it report no cache_misses counter
+ */
+class CacheMisses
+{
+    public:
+    CacheMisses () : _fd(-1)
+    {
+        perf_event_attr a;
+        std::memset(&a, 0, sizeof(a));
+        a.size = sizeof(a);
+        a.type = PERF_TYPE_HARDWARE;
+        a.config = PERF_COUNT_HW_CACHE_MISSES;
+        a.exclude_kernel = 1;
+        a.exclude_hv = 1;
+        _fd = syscall(SYS_perf_event_open, &a, 0, -1, -1, 0);
+        if(_fd >= 0)
+        {
+            ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+        }
+    }
+
+    ~CacheMisses ()
+    {
+        if(_fd >= 0)
+        {
+            close(_fd);
+        }
+    }
+
+    bool available () const
+    {
+        return _fd >= 0;
+    }
+
+    /**
+     * @return the misses so far, 0 if the counter is not available
+     */
+    long long count () const
+    {
+        long long c = 0;
+        if(_fd < 0 || read(_fd, &c, sizeof(c)) != sizeof(c))
+        {
+            return 0;
+        }
+        return c;
+    }
+
+    private:
+        int _fd;
+
+        CacheMisses (const CacheMisses&);
+        CacheMisses& operator = (const CacheMisses&);
+};
+
+// ----------
+// generators
+// ----------
+
+/*
+Every shape up to power_law is a DAG (edges go from a lower to a higher vertex_descriptor),
+so that has_cycle and topological_sort traverse the whole graph instead of stopping at the
+first back edge. cyclic is only for the strongly connected components, local for the reordering.
+*/
+enum GraphShape {sparse, dense, chain, wide, power_law, cyclic, local};
+
+const char* const shape_names[] = {"sparse", "dense", "chain", "wide", "power_law", "cyclic", "local"};
+
+/**
+ * generate about m edges of the given shape, in a random order except for chain
+ *   sparse      m / 8 vertices, uniformly random edges
+ *   dense       sqrt(4m) vertices, each of the n(n-1)/2 forward pairs kept with probability about 1/2
+ *   chain       m + 1 vertices, i -> i + 1
+ *   wide        5 layers of m / 32 vertices, 8 random edges from each vertex into the next layer
+ *   power_law   m / 8 vertices, targets drawn with a heavy skew so a few hubs get most of the edges
+ *   cyclic      sparse with every other edge reversed, one giant component and many small ones
+ *   local       m / 8 vertices, each edge joins two vertices at most 64 apart in a hidden order, the
+ *               vertex_descriptors shuffled, like a mesh or a road network read with arbitrary ids,
+ *               still a DAG since the edges go forward in the hidden order
+ * @param shape the shape
+ * @param m the number of edges to draw, duplicates possible for the random shapes
+ * @return the edge list
+ */
+EdgeList generate_edges (GraphShape shape, std::size_t m)
+{
+    EdgeList el;
+    el.reserve(m);
+    std::mt19937_64 rng(m * 5 + shape);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    switch(shape)
+    {
+        case sparse:
+        case power_law:
+        case cyclic:
+        {
+            std::size_t n = std::max<std::size_t>(m / 8, 2);
+            std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+            while(el.size() < m)
+            {
+                std::size_t u = pick(rng);
+                std::size_t v = shape == sparse ? pick(rng) : static_cast<std::size_t>((n - 1) * std::pow(unit(rng), 3.0));
+                if(u != v && shape == cyclic && el.size() % 2 == 1)
+                {
+                    el.push_back(std::make_pair(std::max(u, v), std::min(u, v)));
+                }
+                else if(u != v)
+                {
+                    el.push_back(std::make_pair(std::min(u, v), std::max(u, v)));
+                }
+            }
+            break;
+        }
+        case dense:
+        {
+            std::size_t n = static_cast<std::size_t>(std::sqrt(4.0 * m)) + 1;
+            double p = static_cast<double>(m) / (n * (n - 1) / 2);
+            for(std::size_t u = 0; u < n; ++u)
+            {
+                for(std::size_t v = u + 1; v < n; ++v)
+                {
+                    if(unit(rng) < p)
+                    {
+                        el.push_back(std::make_pair(u, v));
+                    }
+                }
+            }
+            std::shuffle(el.begin(), el.end(), rng);
+            break;
+        }
+        case chain:
+        {
+            for(std::size_t i = 0; i < m; ++i)
+            {
+                el.push_back(std::make_pair(i, i + 1));
+            }
+            break;
+        }
+        case wide:
+        {
+            std::size_t w = std::max<std::size_t>(m / 32, 1);
+            std::uniform_int_distribution<std::size_t> pick(0, w - 1);
+            for(std::size_t layer = 0; layer < 4; ++layer)
+            {
+                for(std::size_t i = 0; i < w; ++i)
+                {
+                    for(std::size_t k = 0; k < 8; ++k)
+                    {
+                        el.push_back(std::make_pair(layer * w + i, (layer + 1) * w + pick(rng)));
+                    }
+                }
+            }
+            std::shuffle(el.begin(), el.end(), rng);
+            break;
+        }
+        case local:
+        {
+            std::size_t n = std::max<std::size_t>(m / 8, 65);
+            std::vector<std::size_t> label(n);
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                label[i] = i;
+            }
+            std::shuffle(label.begin(), label.end(), rng);
+            std::uniform_int_distribution<std::size_t> pick(0, n - 65);
+            std::uniform_int_distribution<std::size_t> step(1, 64);
+            while(el.size() < m)
+            {
+                std::size_t u = pick(rng);
+                el.push_back(std::make_pair(label[u], label[u + step(rng)]));
+            }
+            break;
+        }
+    }
+    return el;
+}
+
+/**
+ * the last edge list generated, benchmarks on the same input share it
+ * @param shape the shape
+ * @param m the number of edges
+ * @return the cached edge list
+ */
+const EdgeList& cached_edges (GraphShape shape, std::size_t m)
+{
+    static GraphShape cached_shape = sparse;
+    static std::size_t cached_m = 0;
+    static EdgeList el;
+    if(cached_m != m || cached_shape != shape)
+    {
+        EdgeList().swap(el);
+        el = generate_edges(shape, m);
+        cached_shape = shape;
+        cached_m = m;
+    }
+    return el;
+}
+
+/**
+ * build a graph the way a user of the free functions would, with add_edge
+ * @param el the edges
+ * @return the graph
+ */
+template <typename G>
+G build_graph (const EdgeList& el)
+{
+    G g;
+    for(std::size_t i = 0; i < el.size(); ++i)
+    {
+        add_edge(el[i].first, el[i].second, g);
+    }
+    return g;
+}
+
+/**
+ * the read-only graphs are built in bulk, add_edge is O(V + E) or missing for them
+ */
+template <>
+CsrGraph build_graph<CsrGraph> (const EdgeList& el)
+{
+    return CsrGraph(el.begin(), el.end());
+}
+
+template <>
+CompressedGraph build_graph<CompressedGraph> (const EdgeList& el)
+{
+    return CompressedGraph(el.begin(), el.end());
+}
+
+/**
+ * the last graph built for each graph type, benchmarks on the same input share it
+ * @param shape the shape
+ * @param m the number of edges
+ * @return the cached graph
+ */
+template <typename G>
+const G& cached_graph (GraphShape shape, std::size_t m)
+{
+    static GraphShape cached_shape = sparse;
+    static std::size_t cached_m = 0;
+    static G g;
+    if(cached_m != m || cached_shape != shape)
+    {
+        g = G();
+        g = build_graph<G>(cached_edges(shape, m));
+        cached_shape = shape;
+        cached_m = m;
+    }
+    return g;
+}
+
+// --------------------------------
+// free functions, Graph and boost
+// --------------------------------
+
+template <typename G>
+void BM_add_edge (benchmark::State& state, GraphShape shape)
+{
+    const EdgeList& el = cached_edges(shape, state.range(0));
+    for(auto _ : state)
+    {
+        G g = build_graph<G>(el);
+        benchmark::DoNotOptimize(num_edges(g));
+    }
+    state.SetItemsProcessed(state.iterations() * el.size());
+}
+
+template <typename G>
+void BM_add_vertex (benchmark::State& state)
+{
+    for(auto _ : state)
+    {
+        G g;
+        for(std::size_t i = 0; i < static_cast<std::size_t>(state.range(0)); ++i)
+        {
+            add_vertex(g);
+        }
+        benchmark::DoNotOptimize(num_vertices(g));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename G>
+void BM_edge (benchmark::State& state, GraphShape shape)
+{
+    const G& g = cached_graph<G>(shape, state.range(0));
+    const EdgeList& el = cached_edges(shape, state.range(0));
+    std::size_t queries = std::min<std::size_t>(el.size(), 1 << 20);
+    std::size_t found = 0;
+    for(auto _ : state)
+    {
+        for(std::size_t i = 0; i < queries; ++i)
+        {
+            found += edge(el[i].first, el[i].second, g).second; //present
+            found += edge(el[i].second, el[i].first, g).second; //absent, the graph is a DAG
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations() * 2 * queries);
+}
+
+template <typename G>
+void BM_adjacent_vertices (benchmark::State& state, GraphShape shape)
+{
+    const G& g = cached_graph<G>(shape, state.range(0));
+    for(auto _ : state)
+    {
+        std::size_t sum = 0;
+        for(std::size_t v = 0; v < num_vertices(g); ++v)
+        {
+            typename G::adjacency_iterator b, e;
+            for(boost::tie(b, e) = adjacent_vertices(vertex(v, g), g); b != e; ++b)
+            {
+                sum += *b;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * (num_vertices(g) + num_edges(g)));
+}
+
+template <typename G>
+void BM_has_cycle (benchmark::State& state, GraphShape shape)
+{
+    const G& g = cached_graph<G>(shape, state.range(0));
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(::has_cycle(g));
+    }
+    state.SetItemsProcessed(state.iterations() * (num_vertices(g) + num_edges(g)));
+}
+
+template <typename G>
+void BM_topological_sort (benchmark::State& state, GraphShape shape)
+{
+    const G& g = cached_graph<G>(shape, state.range(0));
+    std::vector<typename G::vertex_descriptor> order;
+    order.reserve(num_vertices(g));
+    for(auto _ : state)
+    {
+        order.clear();
+        ::topological_sort(g, std::back_inserter(order));
+        benchmark::DoNotOptimize(order.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (num_vertices(g) + num_edges(g)));
+}
+
+/**
+ * heap held by the graph once built, per edge, and allocations made to build it
+ */
+template <typename G>
+void BM_footprint (benchmark::State& state, GraphShape shape)
+{
+    const EdgeList& el = cached_edges(shape, state.range(0));
+    long bytes = 0;
+    long allocations = 0;
+    std::size_t edges = 0;
+    for(auto _ : state)
+    {
+        long b = heap_bytes.load();
+        long a = heap_allocations.load();
+        G g = build_graph<G>(el);
+        bytes = heap_bytes.load() - b;
+        allocations = heap_allocations.load() - a;
+        edges = num_edges(g);
+    }
+    state.counters["bytes_per_edge"] = static_cast<double>(bytes) / edges;
+    state.counters["allocations"] = allocations;
+}
+
+/**
+ * register every free function and algorithm benchmark for one graph type
+ * @param name the graph type, as it appears in the benchmark names
+ * @param max_edges the largest input
+ */
+template <typename G>
+void register_graph_benchmarks (const std::string& name, std::size_t max_edges)
+{
+    for(std::size_t m = 1000; m <= max_edges; m *= 10)
+    {
+        benchmark::RegisterBenchmark(("add_vertex/" + name).c_str(), BM_add_vertex<G>)->Arg(m)->Unit(benchmark::kMillisecond);
+        for(int s = sparse; s <= power_law; ++s)
+        {
+            GraphShape shape = static_cast<GraphShape>(s);
+            std::string suffix = "/" + name + "/" + shape_names[s];
+            benchmark::RegisterBenchmark(("add_edge" + suffix).c_str(), BM_add_edge<G>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("footprint" + suffix).c_str(), BM_footprint<G>, shape)->Arg(m)->Unit(benchmark::kMillisecond)->Iterations(1);
+            benchmark::RegisterBenchmark(("edge" + suffix).c_str(), BM_edge<G>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("adjacent_vertices" + suffix).c_str(), BM_adjacent_vertices<G>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("has_cycle" + suffix).c_str(), BM_has_cycle<G>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("topological_sort" + suffix).c_str(), BM_topological_sort<G>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+        }
+    }
+}
+
+// -----
+// arena
+// -----
+
+/**
+ * build a graph with add_edge and destroy it, the allocator's whole life cycle
+ */
+template <typename G>
+void BM_build_destroy (benchmark::State& state, GraphShape shape)
+{
+    const EdgeList& el = cached_edges(shape, state.range(0));
+    long a = heap_allocations.load();
+    for(auto _ : state)
+    {
+        G g = build_graph<G>(el);
+        benchmark::DoNotOptimize(num_edges(g));
+    }
+    state.SetItemsProcessed(state.iterations() * el.size());
+    state.counters["allocations"] = static_cast<double>(heap_allocations.load() - a) / state.iterations();
+}
+
+/**
+ * the same, with every container of the graph on one MonotonicArena that is released at the end
+ */
+template <typename G>
+void BM_build_destroy_arena (benchmark::State& state, GraphShape shape)
+{
+    const EdgeList& el = cached_edges(shape, state.range(0));
+    long a = heap_allocations.load();
+    for(auto _ : state)
+    {
+        MonotonicArena arena;
+        G g((ArenaAllocator<std::size_t>(arena)));
+        for(std::size_t i = 0; i < el.size(); ++i)
+        {
+            add_edge(el[i].first, el[i].second, g);
+        }
+        benchmark::DoNotOptimize(num_edges(g));
+    }
+    state.SetItemsProcessed(state.iterations() * el.size());
+    state.counters["allocations"] = static_cast<double>(heap_allocations.load() - a) / state.iterations();
+}
+
+// --------
+// in-edges
+// --------
+
+/**
+ * the in-neighbours of 64 vertices through a scan of every edge, all a directed graph allows
+ */
+void BM_in_neighbours_scan (benchmark::State& state, GraphShape shape)
+{
+    const VectorGraph& g = cached_graph<VectorGraph>(shape, state.range(0));
+    for(auto _ : state)
+    {
+        std::size_t sum = 0;
+        for(std::size_t q = 0; q < 64; ++q)
+        {
+            std::size_t v = (q * 2654435761u) % num_vertices(g);
+            VectorGraph::edge_iterator b, e;
+            for(boost::tie(b, e) = edges(g); b != e; ++b)
+            {
+                if(target(*b, g) == v)
+                {
+                    sum += source(*b, g);
+                }
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+
+/**
+ * the same queries through inv_adjacent_vertices
+ */
+void BM_inv_adjacent_vertices (benchmark::State& state, GraphShape shape)
+{
+    const BidirectionalGraph& g = cached_graph<BidirectionalGraph>(shape, state.range(0));
+    for(auto _ : state)
+    {
+        std::size_t sum = 0;
+        for(std::size_t q = 0; q < 64; ++q)
+        {
+            std::size_t v = (q * 2654435761u) % num_vertices(g);
+            BidirectionalGraph::inv_adjacency_iterator b, e;
+            for(boost::tie(b, e) = inv_adjacent_vertices(v, g); b != e; ++b)
+            {
+                sum += *b;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+
+// ---------------
+// ConcurrentGraph
+// ---------------
+
+const std::size_t reader_queries = 1000000; /*!< adjacent_vertices queries per reader thread */
+
+/**
+ * range(1) reader threads query snapshots of a ConcurrentGraph while a writer adds the second half
+ * of the sparse edges in batches of 1000 and publishes each one, a fresh snapshot every 100 queries
+ * the time is the readers' only, from their start to the last one done
+ */
+void BM_concurrent_readers (benchmark::State& state)
+{
+    const EdgeList& el = cached_edges(sparse, state.range(0));
+    Graph start(el.begin(), el.begin() + el.size() / 2);
+    for(auto _ : state)
+    {
+        ConcurrentGraph<> cg(start);
+        std::atomic<bool> done(false);
+        std::thread writer([&] ()
+        {
+            for(std::size_t i = el.size() / 2; i < el.size() && !done.load(); i += 1000)
+            {
+                add_edges(cg, el.begin() + i, el.begin() + std::min(i + 1000, el.size()));
+                publish(cg);
+            }
+        });
+        std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+        std::vector<std::thread> readers;
+        for(long r = 0; r < state.range(1); ++r)
+        {
+            readers.push_back(std::thread([&cg, r] ()
+            {
+                std::size_t sum = 0;
+                ConcurrentGraph<>::snapshot_type s;
+                for(std::size_t q = 0; q < reader_queries; ++q)
+                {
+                    if(q % 100 == 0)
+                    {
+                        s = snapshot(cg);
+                    }
+                    GraphSnapshot::adjacency_iterator b, e;
+                    for(boost::tie(b, e) = adjacent_vertices((q * 2654435761u + r) % num_vertices(*s), *s); b != e; ++b)
+                    {
+                        sum += *b;
+                    }
+                }
+                benchmark::DoNotOptimize(sum);
+            }));
+        }
+        for(std::size_t r = 0; r < readers.size(); ++r)
+        {
+            readers[r].join();
+        }
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count());
+        done.store(true);
+        writer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1) * reader_queries);
+}
+
+/**
+ * the same workload on one Graph behind a mutex, readers wait for the writer and for each other
+ */
+void BM_locked_readers (benchmark::State& state)
+{
+    const EdgeList& el = cached_edges(sparse, state.range(0));
+    Graph start(el.begin(), el.begin() + el.size() / 2);
+    for(auto _ : state)
+    {
+        Graph g(start);
+        std::mutex m;
+        std::atomic<bool> done(false);
+        std::thread writer([&] ()
+        {
+            for(std::size_t i = el.size() / 2; i < el.size() && !done.load(); i += 1000)
+            {
+                std::lock_guard<std::mutex> lock(m);
+                add_edges(g, el.begin() + i, el.begin() + std::min(i + 1000, el.size()));
+            }
+        });
+        std::chrono::steady_clock::time_point t = std::chrono::steady_clock::now();
+        std::vector<std::thread> readers;
+        for(long r = 0; r < state.range(1); ++r)
+        {
+            readers.push_back(std::thread([&g, &m, r] ()
+            {
+                std::size_t sum = 0;
+                for(std::size_t q = 0; q < reader_queries; ++q)
+                {
+                    std::lock_guard<std::mutex> lock(m);
+                    Graph::adjacency_iterator b, e;
+                    for(boost::tie(b, e) = adjacent_vertices((q * 2654435761u + r) % num_vertices(g), g); b != e; ++b)
+                    {
+                        sum += *b;
+                    }
+                }
+                benchmark::DoNotOptimize(sum);
+            }));
+        }
+        for(std::size_t r = 0; r < readers.size(); ++r)
+        {
+            readers[r].join();
+        }
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count());
+        done.store(true);
+        writer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1) * reader_queries);
+}
+
+// ---------
+// color map
+// ---------
+
+/**
+ * the std::vector<int> colors and the scan that dfs_postorder used before ColorMap, kept as the baseline
+ */
+struct IntColors
+{
+    std::vector<int> colors;
+
+    explicit IntColors (std::size_t n) : colors(n, 0)
+    {}
+
+    void set_black (std::size_t v)
+    {
+        colors[v] = 2;
+    }
+
+    std::size_t find_white (std::size_t from) const
+    {
+        while(from < colors.size() && colors[from] != 0)
+        {
+            ++from;
+        }
+        return from;
+    }
+
+    std::size_t bytes () const
+    {
+        return colors.capacity() * sizeof(int);
+    }
+};
+
+/**
+ * every root a traversal would start from, on range(0) vertices of which one in range(1) is still white
+ */
+template <typename C>
+void BM_find_white (benchmark::State& state)
+{
+    std::size_t n = state.range(0);
+    C colors(n);
+    for(std::size_t v = 0; v < n; ++v)
+    {
+        if(v % state.range(1) != 0)
+        {
+            colors.set_black(v);
+        }
+    }
+    for(auto _ : state)
+    {
+        std::size_t roots = 0;
+        for(std::size_t v = colors.find_white(0); v != n; v = colors.find_white(v + 1))
+        {
+            ++roots;
+        }
+        benchmark::DoNotOptimize(roots);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+    state.counters["bytes_per_vertex"] = static_cast<double>(colors.bytes()) / n;
+}
+
+// ----------------
+// add_edge_acyclic
+// ----------------
+
+/**
+ * a stream of insertions that must keep the graph acyclic, checked from scratch: add_edge then has_cycle
+ */
+void BM_add_edge_has_cycle (benchmark::State& state, GraphShape shape)
+{
+    const EdgeList& el = cached_edges(shape, state.range(0));
+    for(auto _ : state)
+    {
+        Graph g;
+        for(std::size_t i = 0; i < el.size(); ++i)
+        {
+            add_edge(el[i].first, el[i].second, g);
+            benchmark::DoNotOptimize(::has_cycle(g));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * el.size());
+}
+
+/**
+ * the same stream through add_edge_acyclic, with range(1) != 0 every other edge is reversed
+ * so that about half the stream is refused
+ */
+void BM_add_edge_acyclic (benchmark::State& state, GraphShape shape)
+{
+    const EdgeList& el = cached_edges(shape, state.range(0));
+    std::size_t refused = 0;
+    for(auto _ : state)
+    {
+        Graph g;
+        refused = 0;
+        for(std::size_t i = 0; i < el.size(); ++i)
+        {
+            try
+            {
+                if(state.range(1) != 0 && i % 2 == 1)
+                {
+                    add_edge_acyclic(el[i].second, el[i].first, g);
+                }
+                else
+                {
+                    add_edge_acyclic(el[i].first, el[i].second, g);
+                }
+            }
+            catch(const boost::not_a_dag&)
+            {
+                ++refused;
+            }
+        }
+        benchmark::DoNotOptimize(num_edges(g));
+    }
+    state.SetItemsProcessed(state.iterations() * el.size());
+    state.counters["refused"] = refused;
+}
+
+/**
+ * register the benchmarks of the queries and the algorithms for a graph type built in bulk
+ * @param name the graph type, as it appears in the benchmark names
+ * @param max_edges the largest input
+ */
+template <typename G>
+void register_read_only_benchmarks (const std::string& name, std::size_t max_edges)
+{
+    for(std::size_t m = 1000; m <= max_edges; m *= 10)
+    {
+        for(int s = sparse; s <= power_law; ++s)
+        {
+            GraphShape shape = static_cast<GraphShape>(s);
+            std::string suffix = "/" + name + "/" + shape_names[s];
+            benchmark::RegisterBenchmark(("footprint" + suffix).c_str(), BM_footprint<G>, shape)->Arg(m)->Unit(benchmark::kMillisecond)->Iterations(1);
+            benchmark::RegisterBenchmark(("edge" + suffix).c_str(), BM_edge<G>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("adjacent_vertices" + suffix).c_str(), BM_adjacent_vertices<G>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("has_cycle" + suffix).c_str(), BM_has_cycle<G>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("topological_sort" + suffix).c_str(), BM_topological_sort<G>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+        }
+    }
+}
+
+// ---------------------------
+// parallel_topological_levels
+// ---------------------------
+
+void BM_parallel_topological_levels (benchmark::State& state, GraphShape shape)
+{
+    const Graph& g = cached_graph<Graph>(shape, state.range(0));
+    std::vector< std::vector<Graph::vertex_descriptor> > levels;
+    for(auto _ : state)
+    {
+        levels.clear();
+        parallel_topological_levels(g, std::back_inserter(levels), state.range(1));
+        benchmark::DoNotOptimize(levels.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (num_vertices(g) + num_edges(g)));
+    state.counters["levels"] = levels.size();
+}
+
+// ------------------------
+// mixed inserts and removals
+// ------------------------
+
+/**
+ * renumber after a batch of removals, boost's vecS vertex list renumbers at each remove_vertex instead
+ */
+template <typename G>
+void compact_graph (G& g)
+{
+    compact(g);
+}
+
+template <>
+void compact_graph<BoostVecGraph> (BoostVecGraph&)
+{}
+
+template <>
+void compact_graph<BoostBidirectionalGraph> (BoostBidirectionalGraph&)
+{}
+
+/**
+ * m / 10 updates on a copy of a sparse graph of m edges, then one compaction:
+ * 45% add_edge, 45% remove_edge of a vertex's first out-edge, 10% remove_vertex (its edges first)
+ * the copy is not timed
+ */
+template <typename G>
+void BM_mixed_updates (benchmark::State& state)
+{
+    const G& original = cached_graph<G>(sparse, state.range(0));
+    const std::size_t updates = state.range(0) / 10;
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        G g(original);
+        std::mt19937_64 rng(state.range(0));
+        state.ResumeTiming();
+        for(std::size_t i = 0; i < updates; ++i)
+        {
+            std::size_t op = rng() % 20;
+            std::size_t u = rng() % vertex_index_bound(g);
+            std::size_t v = rng() % vertex_index_bound(g);
+            if(vertex(u, g) == G::null_vertex() || vertex(v, g) == G::null_vertex())
+            {
+                continue;
+            }
+            if(op < 9)
+            {
+                if(!edge(u, v, g).second)
+                {
+                    add_edge(u, v, g);
+                }
+            }
+            else if(op < 18)
+            {
+                typename G::adjacency_iterator p = adjacent_vertices(u, g).first;
+                if(p != adjacent_vertices(u, g).second)
+                {
+                    remove_edge(u, *p, g);
+                }
+            }
+            else
+            {
+                clear_vertex(u, g);
+                remove_vertex(u, g);
+            }
+        }
+        compact_graph(g);
+        benchmark::DoNotOptimize(num_edges(g));
+        state.PauseTiming();
+        g = G(); //the destruction is not timed either
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * updates);
+}
+
+// -----------------------------
+// strongly_connected_components
+// -----------------------------
+
+template <typename G>
+void BM_strongly_connected_components (benchmark::State& state, GraphShape shape)
+{
+    const G& g = cached_graph<G>(shape, state.range(0));
+    std::vector<std::size_t> component(num_vertices(g));
+    std::size_t count = 0;
+    for(auto _ : state)
+    {
+        count = strongly_connected_components(g, component.begin());
+        benchmark::DoNotOptimize(component.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (num_vertices(g) + num_edges(g)));
+    state.counters["components"] = count;
+}
+
+template <typename G>
+void BM_parallel_strongly_connected_components (benchmark::State& state, GraphShape shape)
+{
+    const G& g = cached_graph<G>(shape, state.range(0));
+    std::vector<std::size_t> component(num_vertices(g));
+    std::size_t count = 0;
+    for(auto _ : state)
+    {
+        count = parallel_strongly_connected_components(g, component.begin(), state.range(1));
+        benchmark::DoNotOptimize(component.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (num_vertices(g) + num_edges(g)));
+    state.counters["components"] = count;
+}
+
+void BM_boost_strong_components (benchmark::State& state, GraphShape shape)
+{
+    const BoostGraph& g = cached_graph<BoostGraph>(shape, state.range(0));
+    std::vector<std::size_t> component(num_vertices(g));
+    std::size_t count = 0;
+    for(auto _ : state)
+    {
+        count = boost::strong_components(g, boost::make_iterator_property_map(component.begin(), get(boost::vertex_index, g)));
+        benchmark::DoNotOptimize(component.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (num_vertices(g) + num_edges(g)));
+    state.counters["components"] = count;
+}
+
+// ----------
+// reordering
+// ----------
+
+/*
+The same graph with its vertices relabeled by reorder(), or as generated (original_order). The
+random shapes draw their vertex_descriptors at random, so the original labels are what reorder is
+meant to fix. mean_edge_span, the mean |u - v| over the edges, is how far apart in the vertex-indexed
+arrays a traversal jumps; cache_misses is reported where the hardware counters can be read.
+*/
+
+const int original_order = 3; /*!< after the ReorderStrategy values */
+
+const char* const order_names[] = {"bfs", "rcm", "degree", "original"};
+
+/**
+ * the last graph relabeled for each graph type, built in bulk and then reordered
+ * @param shape the shape
+ * @param m the number of edges
+ * @param order a ReorderStrategy or original_order
+ * @return the cached graph
+ */
+template <typename G>
+const G& cached_reordered_graph (GraphShape shape, std::size_t m, int order)
+{
+    static GraphShape cached_shape = sparse;
+    static std::size_t cached_m = 0;
+    static int cached_order = original_order;
+    static G g;
+    if(cached_m != m || cached_shape != shape || cached_order != order)
+    {
+        const EdgeList& el = cached_edges(shape, m);
+        g = G();
+        g = G(el.begin(), el.end());
+        if(order != original_order)
+        {
+            g = reorder(g, static_cast<ReorderStrategy>(order)).graph;
+        }
+        cached_shape = shape;
+        cached_m = m;
+        cached_order = order;
+    }
+    return g;
+}
+
+/**
+ * @param g a graph
+ * @return the mean distance between the two ends of an edge, in vertex_descriptors
+ */
+template <typename G>
+double mean_edge_span (const G& g)
+{
+    double span = 0;
+    std::pair<typename G::edge_iterator, typename G::edge_iterator> p = edges(g);
+    for(; p.first != p.second; ++p.first)
+    {
+        std::size_t u = source(*p.first, g);
+        std::size_t v = target(*p.first, g);
+        span += u < v ? v - u : u - v;
+    }
+    return num_edges(g) == 0 ? 0 : span / num_edges(g);
+}
+
+template <typename G>
+void BM_reorder (benchmark::State& state, GraphShape shape, int order)
+{
+    const G& g = cached_reordered_graph<G>(shape, state.range(0), original_order);
+    for(auto _ : state)
+    {
+        Reordering<G> r = reorder(g, static_cast<ReorderStrategy>(order));
+        benchmark::DoNotOptimize(r.inverse.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (num_vertices(g) + num_edges(g)));
+}
+
+/**
+ * has_cycle (a whole traversal, the shapes are DAGs) on a relabeled graph
+ */
+template <typename G>
+void BM_reordered_has_cycle (benchmark::State& state, GraphShape shape, int order)
+{
+    const G& g = cached_reordered_graph<G>(shape, state.range(0), order);
+    CacheMisses misses;
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(::has_cycle(g));
+    }
+    state.SetItemsProcessed(state.iterations() * (num_vertices(g) + num_edges(g)));
+    state.counters["mean_edge_span"] = mean_edge_span(g);
+    if(misses.available())
+    {
+        state.counters["cache_misses"] = benchmark::Counter(misses.count(), benchmark::Counter::kAvgIterations);
+    }
+}
+
+/**
+ * topological_sort on a relabeled graph
+ */
+template <typename G>
+void BM_reordered_topological_sort (benchmark::State& state, GraphShape shape, int order)
+{
+    const G& g = cached_reordered_graph<G>(shape, state.range(0), order);
+    std::vector<typename G::vertex_descriptor> result;
+    result.reserve(num_vertices(g));
+    CacheMisses misses;
+    for(auto _ : state)
+    {
+        result.clear();
+        ::topological_sort(g, std::back_inserter(result));
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (num_vertices(g) + num_edges(g)));
+    state.counters["mean_edge_span"] = mean_edge_span(g);
+    if(misses.available())
+    {
+        state.counters["cache_misses"] = benchmark::Counter(misses.count(), benchmark::Counter::kAvgIterations);
+    }
+}
+
+// -------
+// loading
+// -------
+
+/**
+ * Graph(first, last) on the sparse edge list, to compare with add_edge/Graph/sparse, which adds the same edges one at a time
+ * 126 ms against 632 ms at 1e6 with the destruction of the graph timed too, add_edges documents the 10M-edge ratio
+ */
+void BM_load_bulk (benchmark::State& state)
+{
+    const EdgeList& el = cached_edges(sparse, state.range(0));
+    for(auto _ : state)
+    {
+        Graph g(el.begin(), el.end());
+        benchmark::DoNotOptimize(num_edges(g));
+    }
+    state.SetItemsProcessed(state.iterations() * el.size());
+}
+
+void BM_load_mapped (benchmark::State& state)
+{
+    const EdgeList& el = cached_edges(sparse, state.range(0));
+    save_graph(CsrGraph(el.begin(), el.end()), "BenchGraph.tmp.graph");
+    for(auto _ : state)
+    {
+        MappedGraph g("BenchGraph.tmp.graph", state.range(1) != 0);
+        benchmark::DoNotOptimize(num_edges(g));
+    }
+    std::remove("BenchGraph.tmp.graph");
+    state.SetItemsProcessed(state.iterations() * el.size());
+}
+
+/**
+ * write the sparse edge list of m edges as text, once per size
+ * @param m the number of edges
+ * @return the file name
+ */
+std::string cached_edge_list_file (std::size_t m)
+{
+    static std::size_t cached_m = 0;
+    const char* path = "BenchGraph.tmp.txt";
+    if(cached_m != m)
+    {
+        const EdgeList& el = cached_edges(sparse, m);
+        std::ofstream out(path);
+        for(std::size_t i = 0; i < el.size(); ++i)
+        {
+            out << el[i].first << " " << el[i].second << "\n";
+        }
+        cached_m = m;
+    }
+    return path;
+}
+
+void BM_read_iostream (benchmark::State& state)
+{
+    std::string path = cached_edge_list_file(state.range(0));
+    for(auto _ : state)
+    {
+        std::ifstream in(path.c_str());
+        Graph g;
+        std::size_t u, v;
+        while(in >> u >> v)
+        {
+            add_edge(u, v, g);
+        }
+        benchmark::DoNotOptimize(num_edges(g));
+    }
+    std::ifstream in(path.c_str(), std::ios::ate);
+    state.SetBytesProcessed(state.iterations() * in.tellg());
+}
+
+void BM_read_edge_list (benchmark::State& state)
+{
+    std::string path = cached_edge_list_file(state.range(0));
+    EdgeListOptions options;
+    options.threads = state.range(1);
+    std::size_t bytes = 0;
+    for(auto _ : state)
+    {
+        Graph g;
+        bytes = read_edge_list(path, g, options).bytes;
+        benchmark::DoNotOptimize(num_edges(g));
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+}
+
+/**
+ * what a reader of the counters pays, graph_stats(g) on a graph that has been used, nothing without GRAPH_STATS
+ */
+void BM_graph_stats (benchmark::State& state)
+{
+    Graph g;
+    add_edge(0, 1, g);
+    has_cycle(g);
+    for(auto _ : state)
+    {
+        GraphStatsSnapshot s = graph_stats(g);
+        benchmark::DoNotOptimize(&s);
+    }
+}
+
+/**
+ * parsing alone, no graph, to see how fast the text is turned into edges
+ */
+void BM_parse_edge_chunk (benchmark::State& state)
+{
+    std::string path = cached_edge_list_file(state.range(0));
+    std::ifstream in(path.c_str(), std::ios::binary);
+    std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EdgeList edges;
+    edges.reserve(state.range(0));
+    for(auto _ : state)
+    {
+        EdgeListReport report;
+        edges.clear();
+        parse_edge_chunk(text.data(), text.data() + text.size(), 0, 0, edges, report);
+        benchmark::DoNotOptimize(edges.data());
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+// ----
+// main
+// ----
+
+int main (int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+#ifdef GRAPH_STATS
+    benchmark::AddCustomContext("graph_stats", "on");
+#else
+    benchmark::AddCustomContext("graph_stats", "off");
+#endif
+    const char* env = std::getenv("BENCH_GRAPH_MAX_EDGES");
+    std::size_t max_edges = env ? std::strtoull(env, 0, 10) : 1000000;
+
+    register_graph_benchmarks<Graph>("Graph", max_edges);
+    register_graph_benchmarks<VectorGraph>("basic_graph<vectorS,vectorS>", max_edges);
+    register_graph_benchmarks<SmallVectorGraph>("basic_graph<small_vectorS<4>,vectorS>", max_edges);
+    register_graph_benchmarks<BoostGraph>("adjacency_list", max_edges);
+    register_read_only_benchmarks<CsrGraph>("CsrGraph", max_edges);
+    register_read_only_benchmarks<CompressedGraph>("CompressedGraph", max_edges);
+
+    benchmark::RegisterBenchmark("graph_stats/Graph", BM_graph_stats);
+
+    for(std::size_t n = 1000000; n <= 100 * max_edges; n *= 10)
+    {
+        for(long every = 1; every <= 1000; every *= 1000)
+        {
+            benchmark::RegisterBenchmark("find_white/vector<int>", BM_find_white<IntColors>)->Args({static_cast<long>(n), every})->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark("find_white/ColorMap", BM_find_white<ColorMap>)->Args({static_cast<long>(n), every})->Unit(benchmark::kMillisecond);
+        }
+    }
+
+    for(std::size_t m = 1000; m <= max_edges; m *= 10)
+    {
+        for(int s = sparse; s <= power_law; ++s)
+        {
+            GraphShape shape = static_cast<GraphShape>(s);
+            std::string suffix = std::string("/") + shape_names[s];
+            benchmark::RegisterBenchmark(("build_destroy/Graph" + suffix).c_str(), BM_build_destroy<Graph>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("build_destroy/basic_graph<dequeS,dequeS,ArenaAllocator>" + suffix).c_str(), BM_build_destroy_arena<ArenaGraph>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("build_destroy/basic_graph<vectorS,vectorS>" + suffix).c_str(), BM_build_destroy<VectorGraph>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("build_destroy/basic_graph<vectorS,vectorS,ArenaAllocator>" + suffix).c_str(), BM_build_destroy_arena<ArenaVectorGraph>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("build_destroy/basic_graph<small_vectorS<4>,vectorS>" + suffix).c_str(), BM_build_destroy<SmallVectorGraph>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("build_destroy/basic_graph<small_vectorS<4>,vectorS,ArenaAllocator>" + suffix).c_str(), BM_build_destroy_arena<ArenaSmallVectorGraph>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+        }
+        for(int s = sparse; s <= power_law; ++s)
+        {
+            GraphShape shape = static_cast<GraphShape>(s);
+            std::string suffix = std::string("/Graph/") + shape_names[s];
+            if(m <= 10000) //quadratic
+            {
+                benchmark::RegisterBenchmark(("add_edge_has_cycle" + suffix).c_str(), BM_add_edge_has_cycle, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            }
+            benchmark::RegisterBenchmark(("add_edge_acyclic" + suffix).c_str(), BM_add_edge_acyclic, shape)->Args({static_cast<long>(m), 0})->Unit(benchmark::kMillisecond);
+            std::string bidirectional_suffix = std::string("/basic_graph<vectorS,vectorS,bidirectionalS>/") + shape_names[s];
+            benchmark::RegisterBenchmark(("add_edge" + bidirectional_suffix).c_str(), BM_add_edge<BidirectionalGraph>, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("footprint" + bidirectional_suffix).c_str(), BM_footprint<BidirectionalGraph>, shape)->Arg(m)->Unit(benchmark::kMillisecond)->Iterations(1);
+            benchmark::RegisterBenchmark(("in_neighbours_scan/basic_graph<vectorS,vectorS>/" + std::string(shape_names[s])).c_str(), BM_in_neighbours_scan, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("inv_adjacent_vertices" + bidirectional_suffix).c_str(), BM_inv_adjacent_vertices, shape)->Arg(m)->Unit(benchmark::kMillisecond);
+            if(m <= 100000)
+            {
+                benchmark::RegisterBenchmark(("add_edge_acyclic" + suffix).c_str(), BM_add_edge_acyclic, shape)->Args({static_cast<long>(m), 1})->Unit(benchmark::kMillisecond);
+            }
+        }
+        for(std::size_t threads = 1; threads <= 8; threads *= 2)
+        {
+            benchmark::RegisterBenchmark("concurrent_readers/ConcurrentGraph/sparse", BM_concurrent_readers)->Args({static_cast<long>(m), static_cast<long>(threads)})->Unit(benchmark::kMillisecond)->UseManualTime();
+            benchmark::RegisterBenchmark("locked_readers/Graph/sparse", BM_locked_readers)->Args({static_cast<long>(m), static_cast<long>(threads)})->Unit(benchmark::kMillisecond)->UseManualTime();
+            benchmark::RegisterBenchmark("parallel_topological_levels/Graph/sparse", BM_parallel_topological_levels, sparse)->Args({static_cast<long>(m), static_cast<long>(threads)})->Unit(benchmark::kMillisecond)->UseRealTime();
+            benchmark::RegisterBenchmark("parallel_strongly_connected_components/CsrGraph/cyclic", BM_parallel_strongly_connected_components<CsrGraph>, cyclic)->Args({static_cast<long>(m), static_cast<long>(threads)})->Unit(benchmark::kMillisecond)->UseRealTime();
+        }
+        if(m <= 100000) //O(V + E) per vertex removal without in-rows
+        {
+            benchmark::RegisterBenchmark("mixed_updates/Graph/sparse", BM_mixed_updates<Graph>)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark("mixed_updates/basic_graph<vectorS,vectorS>/sparse", BM_mixed_updates<VectorGraph>)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark("mixed_updates/basic_graph<vectorS,vectorS,bidirectionalS>/sparse", BM_mixed_updates<BidirectionalGraph>)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark("mixed_updates/adjacency_list<vecS,vecS,directedS>/sparse", BM_mixed_updates<BoostVecGraph>)->Arg(m)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark("mixed_updates/adjacency_list<vecS,vecS,bidirectionalS>/sparse", BM_mixed_updates<BoostBidirectionalGraph>)->Arg(m)->Unit(benchmark::kMillisecond);
+        }
+        benchmark::RegisterBenchmark("strongly_connected_components/Graph/cyclic", BM_strongly_connected_components<Graph>, cyclic)->Arg(m)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("strongly_connected_components/CsrGraph/cyclic", BM_strongly_connected_components<CsrGraph>, cyclic)->Arg(m)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("strong_components/adjacency_list/cyclic", BM_boost_strong_components, cyclic)->Arg(m)->Unit(benchmark::kMillisecond);
+        const GraphShape random_labels[] = {sparse, power_law, local};
+        for(std::size_t k = 0; k < 3; ++k)
+        {
+            GraphShape shape = random_labels[k];
+            for(int order = reorder_bfs; order <= original_order; ++order)
+            {
+                std::string suffix = std::string("/") + shape_names[shape] + "/" + order_names[order];
+                if(order != original_order)
+                {
+                    benchmark::RegisterBenchmark(("reorder/Graph" + suffix).c_str(), BM_reorder<Graph>, shape, order)->Arg(m)->Unit(benchmark::kMillisecond);
+                    benchmark::RegisterBenchmark(("reorder/CsrGraph" + suffix).c_str(), BM_reorder<CsrGraph>, shape, order)->Arg(m)->Unit(benchmark::kMillisecond);
+                }
+                benchmark::RegisterBenchmark(("reordered_has_cycle/Graph" + suffix).c_str(), BM_reordered_has_cycle<Graph>, shape, order)->Arg(m)->Unit(benchmark::kMillisecond);
+                benchmark::RegisterBenchmark(("reordered_has_cycle/CsrGraph" + suffix).c_str(), BM_reordered_has_cycle<CsrGraph>, shape, order)->Arg(m)->Unit(benchmark::kMillisecond);
+                benchmark::RegisterBenchmark(("reordered_topological_sort/Graph" + suffix).c_str(), BM_reordered_topological_sort<Graph>, shape, order)->Arg(m)->Unit(benchmark::kMillisecond);
+                benchmark::RegisterBenchmark(("reordered_topological_sort/CsrGraph" + suffix).c_str(), BM_reordered_topological_sort<CsrGraph>, shape, order)->Arg(m)->Unit(benchmark::kMillisecond);
+            }
+        }
+        benchmark::RegisterBenchmark("load_bulk/Graph/sparse", BM_load_bulk)->Arg(m)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("load_mapped/sparse", BM_load_mapped)->Args({static_cast<long>(m), 0})->Args({static_cast<long>(m), 1})->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("read_iostream/Graph/sparse", BM_read_iostream)->Arg(m)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark("read_edge_list/Graph/sparse", BM_read_edge_list)->Args({static_cast<long>(m), 1})->Args({static_cast<long>(m), 4})->Unit(benchmark::kMillisecond)->UseRealTime();
+        benchmark::RegisterBenchmark("parse_edge_chunk/sparse", BM_parse_edge_chunk)->Arg(m)->Unit(benchmark::kMillisecond);
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    std::remove("BenchGraph.tmp.txt");
+    return 0;
+}
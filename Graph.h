@@ -14,59 +14,215 @@
 
 #include <cassert> // assert
 #include <cstddef> // size_t
+#include <cstdint> // uint64_t
 #include <utility> // make_pair, pair
 #include <deque>  // deque
+#include <vector> // vector
 #include <iterator>
 #include <algorithm> 
+#include <numeric> // partial_sum
+#include <memory> // unique_ptr
+#include <atomic> // atomic
+#include <thread> // thread
+#include <mutex> // mutex, unique_lock
+#include <condition_variable> // condition_variable
+#include "boost/container/small_vector.hpp" // small_vector
+#include "boost/iterator/counting_iterator.hpp" // counting_iterator
+#include "boost/iterator/filter_iterator.hpp" // filter_iterator
+#include "boost/iterator/transform_iterator.hpp" // transform_iterator
+#include "boost/graph/graph_selectors.hpp" // directedS, bidirectionalS
 #include "boost/graph/exception.hpp"// not_a_dag exception
+#include "GraphStats.h" // GraphStatsScope, GRAPH_STATS_BYTES, container_bytes
 
 using std::rel_ops::operator!=;
 
-// -----
-// Graph
-// -----
+// ----------------
+// sort_edge_list
+// ----------------
 
-class Graph 
+/**
+ * turn a range of (source, target) pairs into sorted, duplicate free, compressed sparse rows
+ * a counting sort on the source scatters every target into its row in one pass, then each row is
+ * sorted on its own, by insertion when short: O(V + E) time for rows of bounded degree,
+ * O(V + E log d) with d the largest out-degree, and no array beyond offsets and targets
+ * @param first a forward iterator to std::pair<vertex_descriptor, vertex_descriptor>
+ * @param last end of the range
+ * @param n the minimum number of vertices
+ * @param offsets filled with the V + 1 row offsets
+ * @param targets filled with the rows, back to back
+ * @return the number of vertices, max(n, max(u, v) + 1)
+ */
+template <typename FI>
+std::size_t sort_edge_list (FI first, FI last, std::size_t n, std::vector<std::size_t>& offsets, std::vector<std::size_t>& targets)
 {
+    //size the rows, offsets[v + 1] counts the edges out of v
+    offsets.assign(n + 1, 0);
+    std::size_t m = 0;
+    for(FI i = first; i != last; ++i)
+    {
+        std::size_t top = std::max<std::size_t>(i->first, i->second) + 1;
+        if(top > n)
+        {
+            n = top;
+            offsets.resize(n + 1, 0);
+        }
+        ++offsets[i->first + 1];
+        ++m;
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
 
-    public:
+    //scatter the targets into their rows, offsets[v] moves to the end of row v
+    targets.resize(m);
+    for(FI i = first; i != last; ++i)
+    {
+        targets[offsets[i->first]++] = i->second;
+    }
 
-        //EdgeDescriptor Class
-    class EdgeDescriptor
+    //sort each row and drop its duplicates, which are then adjacent, shifting the rows left over the gaps
+    std::size_t out = 0;
+    std::size_t rb = 0;
+    for(std::size_t v = 0; v < n; ++v)
     {
-        public:
-            std::size_t _source; /*!< source vertex_descriptor */
-            std::size_t _target; /*!< target vertex_descriptor */
+        std::size_t re = offsets[v];
+        std::size_t* b = targets.data() + rb;
+        std::size_t* e = targets.data() + re;
+        if(re - rb <= 16)
+        {
+            for(std::size_t* p = b + 1; p < e; ++p)
+            {
+                std::size_t x = *p;
+                std::size_t* q = p;
+                for(; q != b && q[-1] > x; --q)
+                {
+                    *q = q[-1];
+                }
+                *q = x;
+            }
+        }
+        else
+        {
+            std::sort(b, e);
+        }
+        offsets[v] = out;
+        for(std::size_t* p = b; p != e; ++p)
+        {
+            if(p == b || *p != p[-1])
+            {
+                targets[out++] = *p;
+            }
+        }
+        rb = re;
+    }
+    offsets[n] = out;
+    targets.resize(out);
+    return n;
+}
 
-        /**
-         * default constructor
-         */
-         EdgeDescriptor()
-         {}
+// --------------
+// EdgeDescriptor
+// --------------
 
-        /**
-         * constructor
-         * @param s the sourse vertex_descriptor
-         * @param t the target vertex_descriptor
-         */
-         EdgeDescriptor(std::size_t s, std::size_t t)
-         {
-            _source = s;
-            _target = t;
-         }
+class EdgeDescriptor
+{
+    public:
+        std::size_t _source; /*!< source vertex_descriptor */
+        std::size_t _target; /*!< target vertex_descriptor */
+
+    /**
+     * default constructor
+     */
+     constexpr EdgeDescriptor() : _source(0), _target(0)
+     {}
+
+    /**
+     * constructor, constexpr for StaticGraph
+     * @param s the sourse vertex_descriptor
+     * @param t the target vertex_descriptor
+     */
+     constexpr EdgeDescriptor(std::size_t s, std::size_t t) : _source(s), _target(t)
+     {}
+
+    /**
+     * == operator for EdgeDescriptor
+     * @param lhs a EdgeDescriptor
+     * @param rhs a EdgeDescriptor
+     * @return a bool that indicates whether the EdgeDescriptors are equal
+     */
+    friend constexpr bool operator == (const EdgeDescriptor& lhs, const EdgeDescriptor& rhs)
+    {
+        return (lhs._source == rhs._source) && (lhs._target == rhs._target);
+    }
 
-        /**
-         * == operator for EdgeDescriptor
-         * @param lhs a EdgeDescriptor
-         * @param rhs a EdgeDescriptor
-         * @return a bool that indicates whether the EdgeDescriptors are equal
-         */
-        friend bool operator == (const EdgeDescriptor& lhs, const EdgeDescriptor& rhs)
-        {
-            return (lhs._source == rhs._source) && (lhs._target == rhs._target);
-        }
+};
 
-    };
+// ------------------
+// storage selectors
+// ------------------
+
+/*
+The selectors pick the containers of basic_graph, like boost's vecS and setS do for adjacency_list.
+Rows are kept sorted whatever the container, so only the memory layout and the cost of an
+insertion change, not the behaviour.
+*/
+
+struct dequeS {}; /*!< std::deque, one allocated chunk per container even when empty or tiny */
+
+struct vectorS {}; /*!< std::vector, 3 words plus one exact-ish heap block */
+
+template <std::size_t N>
+struct small_vectorS {}; /*!< boost::container::small_vector, the first N elements stored inline without any allocation */
+
+template <typename Selector, typename T, typename Alloc = std::allocator<T> >
+struct storage_gen;
+
+template <typename T, typename Alloc>
+struct storage_gen<dequeS, T, Alloc>
+{
+    typedef std::deque<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T> > type;
+};
+
+template <typename T, typename Alloc>
+struct storage_gen<vectorS, T, Alloc>
+{
+    typedef std::vector<T, typename std::allocator_traits<Alloc>::template rebind_alloc<T> > type;
+};
+
+template <std::size_t N, typename T, typename Alloc>
+struct storage_gen<small_vectorS<N>, T, Alloc>
+{
+    typedef boost::container::small_vector<T, N, typename std::allocator_traits<Alloc>::template rebind_alloc<T> > type;
+};
+
+// -----------
+// basic_graph
+// -----------
+
+/**
+ * directed graph with sorted per-vertex rows of out-neighbours
+ * with boost::bidirectionalS every vertex also has a sorted row of in-neighbours, kept in sync by add_edge,
+ * add_edge_acyclic and add_edges, for in_edges, in_degree and inv_adjacent_vertices in O(in-degree)
+ * that costs a second row per vertex (the size of a row_type, plus its heap block) and a second
+ * vertex_descriptor per edge (8 bytes), about twice the memory of the adjacency
+ * remove_vertex leaves a tombstone: the vertex_descriptors of the other vertices do not change, vertices()
+ * skips it and the algorithms size their maps by vertex_index_bound(), until compact() renumbers the vertices
+ * the rows hold tombstones too: a removed edge stays in its row, marked, and clear_vertex and remove_vertex
+ * drop the edges into v at once by bumping the generation of v, which the row entries of those edges carry
+ * the iterators skip the entries that stand for no edge, and compact(), or any removal once they outnumber
+ * the edges, takes them out of the rows, so removals are O(1) amortized once the edge is found
+ * that costs two words per vertex, its generation and its in-degree, and a vertex_descriptor has to be
+ * below 2^48, the bits above it in a row entry are its generation
+ * compiled with -DGRAPH_STATS, each graph counts the calls, time, work and allocation of its operations (see GraphStats.h)
+ * @param OutEdgeS selector of the container of each row
+ * @param VertexS selector of the containers indexed by vertex (the vertex list and the list of rows)
+ * @param DirectedS boost::directedS, or boost::bidirectionalS to keep the in-neighbours too
+ * @param Alloc allocator every internal container draws from, rebound to what each one holds
+ */
+template <typename OutEdgeS = dequeS, typename VertexS = dequeS, typename DirectedS = boost::directedS, typename Alloc = std::allocator<std::size_t> >
+class basic_graph 
+{
+
+    public:
+        typedef ::EdgeDescriptor EdgeDescriptor;
 
         // --------
         // typedefs
@@ -75,316 +231,2199 @@ class Graph
         typedef std::size_t vertex_descriptor;
         typedef EdgeDescriptor edge_descriptor;
 
-        typedef std::deque<vertex_descriptor>::iterator vertex_iterator;
-        typedef std::deque<edge_descriptor>::iterator edge_iterator;
-        typedef std::deque<vertex_descriptor>::iterator adjacency_iterator;
-
-        typedef std::size_t vertices_size_type;
-        typedef std::size_t edges_size_type;
+    private:
+        typedef typename storage_gen<VertexS, vertex_descriptor, Alloc>::type vertices_type;
+        typedef typename storage_gen<OutEdgeS, vertex_descriptor, Alloc>::type row_type; /*!< sorted out-neighbours of one vertex */
+        typedef typename storage_gen<VertexS, row_type, Alloc>::type rows_type;
 
-    public:
-        // --------
-        // add_edge
-        // --------
+        static const bool is_bidirectional = boost::is_same<DirectedS, boost::bidirectionalS>::value;
 
-        /**
-         * possibly add an edge_descriptor between two given vertex_descriptor to the graph
-         * @param v1 a vertex_descriptor
-         * @param v2 a vertex_descriptor
-         * @return a pair where first of the pair is the edge_descriptor added and second of the pair indicates whether the EdgeDescriptor has been successfully added
-         */
-        friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor v1, vertex_descriptor v2, Graph& g) 
+        //turns an in-neighbour of _target into the edge from it
+        struct InEdgeMaker
         {
-            edge_descriptor e(v1, v2);
-            //check if the edge_descriptor exists in the graph
-            if(std::find(g._edges.begin(), g._edges.end(), e) == g._edges.end())
+            typedef EdgeDescriptor result_type;
+            vertex_descriptor _target;
+            EdgeDescriptor operator () (vertex_descriptor s) const
             {
-                /* If the VertexList selector is vecS, and if either vertex descriptor u or v (which are integers) has a value greater than the current number of vertices in the graph, 
-                the graph is enlarged so that the number of vertices is std::max(u,v) + 1. */
-                if((v1 > g._vertices.back()) || (v2 >  g._vertices.back()))
-                {
-                    vertices_size_type new_size = std::max(v1, v2) + 1;
-                    g._vertices.resize(new_size);
-                    g._targets.resize(new_size);
-                 }
-
-                (g._targets[v1]).push_back(v2); //add v1's adjacent vertex_descriptor (which is v2)
-
-                g._edges.push_back(e); //add edge_descriptor
+                return EdgeDescriptor(s, _target);
+            }
+        };
 
-                return std::make_pair(e, true);
-                
+        //false for the tombstones remove_vertex leaves in _vertices
+        struct IsLive
+        {
+            bool operator () (vertex_descriptor v) const
+            {
+                return v != null_vertex();
             }
-            else
+        };
+
+        //orders row entries by their targets, whatever their generations
+        struct TargetLess
+        {
+            bool operator () (vertex_descriptor entry, vertex_descriptor v) const
             {
-                return std::make_pair(e, false);
+                return (entry & target_mask) < v;
             }
-            
-        }
+        };
 
-        // ----------
-        // add_vertex
-        // ----------
+        static const unsigned generation_shift = 48; /*!< a row entry is its target below this bit, the target's generation above it */
+
+        static const vertex_descriptor target_mask = (vertex_descriptor(1) << generation_shift) - 1;
+
+        static const vertex_descriptor max_generation = (vertex_descriptor(1) << 15) - 1;
+
+        static const vertex_descriptor removed_edge = vertex_descriptor(1) << 63; /*!< set in the entry of a removed edge, which then matches no generation */
+
+    public:
+        //RowIterator Class
+    /**
+     * walks the targets of a row, skipping the entries that stand for no edge any more
+     */
+    class RowIterator
+    {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef vertex_descriptor value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const vertex_descriptor* pointer;
+            typedef vertex_descriptor reference;
 
         /**
-         * add a vertex_descriptor to the graph
-         * @param g the graph where vertex_descriptor is added
-         * @return the vertex_descriptor added
+         * default constructor, equal to the end of any row
+         */
+        RowIterator() : _pos(), _left(0), _generation(0)
+        {}
+
+        /**
+         * constructor, positioned on the first entry from pos on that stands for an edge
+         * @param pos an entry of a row
+         * @param left the number of entries from pos to the end of the row
+         * @param generation the generations of the vertices, 0 when every entry stands for an edge
          */
-        friend vertex_descriptor add_vertex (Graph& g) 
+        RowIterator(typename row_type::const_iterator pos, std::size_t left, const vertices_type* generation) : _pos(pos), _left(left), _generation(generation)
         {
-            g._vertices.push_back(g._vertices.size());
-            g._targets.push_back(std::deque<vertex_descriptor>());
-            return g._vertices.back();
+            skip_tombstones();
         }
 
-        // -----------------
-        // adjacent_vertices
-        // -----------------
-
         /**
-         * adjacent_vertices function
-         * @param v a vertex_descriptor
-         * @param g the graph where the vertex_descriptor is
-         * @return a pair of adjacency_iterators, where the first iterator can travel to the second one the eventually visit all the adjacent vertices of the vertex_descriptor
+         * dereference operator
+         * @return the target currently pointed at
          */
-        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor v, const Graph& g) 
+        reference operator * () const
         {
-            Graph& cg = const_cast<Graph&>(g);
-            adjacency_iterator b = (cg._targets[v]).begin();
-            adjacency_iterator e = (cg._targets[v]).end();
-            return std::make_pair(b, e);
+            return *_pos & target_mask;
         }
 
-        // ----
-        // edge
-        // ----
-
         /**
-         * edge function
-         * @param v1 a vertex_descriptor
-         * @param v2 a vertex_descriptor
-         * @param g the graph where the vertex_descriptor is
-         * @return a pair, where first is the edge_descriptor between the vertices, second is a bool indicates whether the edge_descriptor exists in the graph
+         * pre-increment operator
+         * @return this RowIterator
          */
-        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor v1, vertex_descriptor v2, const Graph& g) 
+        RowIterator& operator ++ ()
         {
-            edge_descriptor e(v1, v2);
-            if(std::find(g._edges.begin(), g._edges.end(), e) == g._edges.end())
-            {
-                return std::make_pair(e, false);
-            }
-            else
-            {
-                return std::make_pair(e, true);
-            }
+            ++_pos;
+            --_left;
+            skip_tombstones();
+            return *this;
         }
 
-        // -----
-        // edges
-        // -----
-
         /**
-         * edges function
-         * @param g a Graph
-         * @return a pair of edge_iterator in which the first can travel to the second one the eventually visits all the edges in the given graph
+         * post-increment operator
+         * @return a copy of this RowIterator before it was incremented
          */
-        friend std::pair<edge_iterator, edge_iterator> edges (const Graph& g) 
+        RowIterator operator ++ (int)
         {
-            Graph& cg = const_cast<Graph&>(g);
-            edge_iterator b = cg._edges.begin();
-            edge_iterator e = cg._edges.end();
-            return std::make_pair(b, e);
+            RowIterator x = *this;
+            ++*this;
+            return x;
         }
 
-        // ---------
-        // num_edge
-        // ---------
-
         /**
-         * num_edge function
-         * @param g a Graph
-         * @return the number of edges in the given graph
+         * == operator for RowIterator
+         * @param lhs a RowIterator
+         * @param rhs a RowIterator into the same row
+         * @return a bool that indicates whether the RowIterators point at the same entry, the ends of every row are equal
          */
-        friend edges_size_type num_edges (const Graph& g) 
+        friend bool operator == (const RowIterator& lhs, const RowIterator& rhs)
         {
-            return g._edges.size();
+            return lhs._left == rhs._left;
         }
 
-        // ------------
-        // num_vertices
-        // ------------
+        private:
+            typename row_type::const_iterator _pos; /*!< the current entry */
+            std::size_t _left; /*!< entries from _pos to the end of the row, 0 at the end */
+            const vertices_type* _generation; /*!< the generations of the vertices, 0 when there are no tombstones to skip */
 
         /**
-         * num_vertices function
-         * @param g a Graph
-         * @return the number of vertices in the given graph
+         * advance _pos until it stands for an edge, an entry whose generation is its target's
          */
-        friend vertices_size_type num_vertices (const Graph& g) 
+        void skip_tombstones()
         {
-            return g._vertices.size();
+            if(_generation != 0)
+            {
+                while(_left != 0 && (*_pos >> generation_shift) != (*_generation)[*_pos & target_mask])
+                {
+                    ++_pos;
+                    --_left;
+                }
+            }
         }
+    };
 
-        // ------
-        // source
-        // ------
+        typedef boost::filter_iterator<IsLive, typename vertices_type::const_iterator> vertex_iterator; /*!< const, a graph hands out no way to change it behind its back */
+        typedef RowIterator adjacency_iterator;
+        typedef RowIterator inv_adjacency_iterator;
+        typedef boost::transform_iterator<InEdgeMaker, RowIterator> in_edge_iterator;
+        typedef std::size_t degree_size_type;
+
+        typedef std::size_t vertices_size_type;
+        typedef std::size_t edges_size_type;
 
         /**
-         * source function
-         * @param r an edge_descriptor
-         * @param g a Graph
-         * @return the source vertex_descriptor of a given edge_descriptor in the given graph
+         * @return the vertex_descriptor of no vertex, what compact() maps a removed vertex to
          */
-        friend vertex_descriptor source (edge_descriptor e, const Graph& g) 
+        static vertex_descriptor null_vertex ()
         {
-            return std::find(g._edges.begin(), g._edges.end(), e)->_source;
+            return vertex_descriptor(-1);
         }
 
-        // ------
-        // target
-        // ------
+    public:
+        //EdgeIterator Class
+    class EdgeIterator
+    {
+        public:
+            typedef std::forward_iterator_tag iterator_category;
+            typedef edge_descriptor value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const edge_descriptor* pointer;
+            typedef edge_descriptor reference;
 
         /**
-         * target function
-         * @param e an edge_descriptor
-         * @param g a Graph
-         * @return the target vertex_descriptor of a given edge_descriptor in the given graph
+         * default constructor
+         */
+        EdgeIterator() : _g(0), _source(0), _pos()
+        {}
+
+        /**
+         * constructor, positioned on the first edge whose source is at least s
+         * @param g the graph being walked
+         * @param s the first source vertex_descriptor to look at
          */
-        friend vertex_descriptor target (edge_descriptor e, const Graph& g) 
+        EdgeIterator(const basic_graph* g, vertex_descriptor s) : _g(g), _source(s), _pos()
         {
-            return std::find(g._edges.begin(), g._edges.end(), e)->_target;
+            skip_empty_rows();
         }
 
-        // ------
-        // vertex
-        // ------
-
         /**
-         * vertex function
-         * @param nth integral value represents the n term index of the vertex
-         * @param g a Graph
-         * @return the nth vertex_descriptor of the graph
+         * dereference operator
+         * @return the edge_descriptor currently pointed at
          */
-        friend vertex_descriptor vertex (vertices_size_type nth, const Graph& g) 
+        reference operator * () const
         {
-            return g._vertices[nth];
+            return edge_descriptor(_source, *_pos);
         }
 
-        // --------
-        // vertices
-        // --------
-
         /**
-         * vertices function
-         * @param g a Graph
-         * @return a pair of vertex_iterator in which the first can travel to the second one the eventually visits all the vertices in the given graph
+         * pre-increment operator, moves to the next target and then to the next non-empty row
+         * @return this EdgeIterator
          */
-        friend std::pair<vertex_iterator, vertex_iterator> vertices (const Graph& g) 
+        EdgeIterator& operator ++ ()
         {
-            Graph& cg = const_cast<Graph&>(g);
-            vertex_iterator b = cg._vertices.begin();
-            vertex_iterator e = cg._vertices.end();
-            return std::make_pair(b, e);
+            if(++_pos == adjacency_iterator())
+            {
+                ++_source;
+                skip_empty_rows();
+            }
+            return *this;
         }
 
-    private:
-        // ----
-        // data
-        // ----
-
-        std::deque<vertex_descriptor> _vertices; /*!< container of the vertex_descriptors */
-
-        std::deque<edge_descriptor> _edges; /*!< container of the edge_descriptors */
-
-        std::deque< std::deque<vertex_descriptor> > _targets; /*!< keep track of the adjacent vertices*/
-        
-
-        // -----
-        // valid
-        // -----
-
         /**
-         * valid function
+         * post-increment operator
+         * @return a copy of this EdgeIterator before it was incremented
          */
-        bool valid () const 
+        EdgeIterator operator ++ (int)
         {
-            return _vertices.size() == 0 && _edges.size() == 0 && _targets.size() == 0;
+            EdgeIterator x = *this;
+            ++*this;
+            return x;
         }
 
-    public:
-        // ------------
-        // constructors
-        // ------------
-
         /**
-         *  default constructor
+         * == operator for EdgeIterator
+         * @param lhs a EdgeIterator
+         * @param rhs a EdgeIterator
+         * @return a bool that indicates whether the EdgeIterators point at the same edge, default constructed ones are equal
          */
-        Graph () : _vertices(), _edges(), _targets()
+        friend bool operator == (const EdgeIterator& lhs, const EdgeIterator& rhs)
         {
-            assert(valid());
+            return (lhs._source == rhs._source) && (lhs._g == 0 || lhs._source == vertex_index_bound(*lhs._g) || lhs._pos == rhs._pos);
         }
 
+        private:
+            const basic_graph* _g; /*!< the graph being walked */
+            vertex_descriptor _source; /*!< source of the current edge, the number of rows once past the end */
+            adjacency_iterator _pos; /*!< target of the current edge inside its row, the end of a row compares equal to adjacency_iterator() */
+
         /**
-         * equal operator
-         * @lhs a Graph
-         * @rhs a Graph
+         * advance _source until it names a row with at least one edge
          */
-        friend bool operator == (const Graph& lhs, const Graph& rhs) 
+        void skip_empty_rows()
         {
-            return lhs._vertices == rhs._vertices && lhs._edges == rhs._edges;
+            for(; _source < vertex_index_bound(*_g); ++_source)
+            {
+                _pos = adjacent_vertices(_source, *_g).first;
+                if(_pos != adjacency_iterator())
+                {
+                    return;
+                }
+            }
         }
+    };
 
-        // Default copy, destructor, and copy assignment
-        // Graph  (const Graph<T>&);
-        // ~Graph ();
-        // Graph& operator = (const Graph&);
+        typedef EdgeIterator edge_iterator;
 
-};
+    public:
+        // --------
+        // add_edge
+        // --------
 
-//helper function for has_cycle
-template <typename G>
-bool has_grey_neighbour (const G& g, typename G::vertex_descriptor v, std::vector<int>& colors)
-{
-    return std::any_of(adjacent_vertices(v, g).first, adjacent_vertices(v, g).second, [&colors](typename G::vertex_descriptor v)
+        /**
+         * possibly add an edge_descriptor between two given vertex_descriptor to the graph
+         * the duplicate check is a binary search in v1's sorted row, O(log deg(v1)), the tombstone of an earlier edge to v2 is used again
+         * a removed vertex the edge touches is brought back
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @return a pair where first of the pair is the edge_descriptor added and second of the pair indicates whether the EdgeDescriptor has been successfully added
+         */
+        friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor v1, vertex_descriptor v2, basic_graph& g) 
         {
-            return colors[v] == 1;
-        });
-}
+            GraphStatsScope stats(g, op_add_edge);
+            edge_descriptor e(v1, v2);
 
-//helper function for DFS (return -1 if no)
-template <typename G>
-int get_white_vertex (const G& g, std::vector<int>& colors)
-{
-    int result = -1;
-    int count = 0;
-    while((std::size_t)count < colors.size() && result == -1)
-    {
-        if(colors[count] == 0)
-        {
-            result = count;
-        }
-        ++count;
+            /* If the VertexList selector is vecS, and if either vertex descriptor u or v (which are integers) has a value greater than the current number of vertices in the graph, 
+            the graph is enlarged so that the number of vertices is std::max(u,v) + 1. */
+            if(std::max(v1, v2) >= g._vertices.size())
+            {
+                g.grow(std::max(v1, v2) + 1);
+            }
+            if(g._num_removed != 0)
+            {
+                g.revive(v1);
+                g.revive(v2);
+            }
+
+            row_type& row = g._targets[v1];
+            typename row_type::iterator p = std::lower_bound(row.begin(), row.end(), v2, TargetLess());
+            //check if the edge_descriptor exists in the graph
+            if(p != row.end() && *p == g.entry_of(v2))
+            {
+                return std::make_pair(e, false);
+            }
+
+            g.put_entry(row, p, v2, stats); //add v1's adjacent vertex_descriptor (which is v2), keeping the row sorted
+            ++g._num_edges;
+            ++g._in_degree[v2];
+            g.add_source(v1, v2, stats);
+            if(g._ordered && g._position[v1] >= g._position[v2]) //a self loop is a cycle too
+            {
+                g.forget_order();
+            }
+
+            return std::make_pair(e, true);
+        }
+
+        // ----------------
+        // add_edge_acyclic
+        // ----------------
+
+        /**
+         * add an edge unless it would close a cycle, keeping a topological order of the graph up to date
+         * the order is repaired the Marchetti-Spaccamela way: when v1 comes after v2, only the vertices reachable
+         * from v2 whose position is not past v1's are searched, and they are moved right after v1, so the cost is
+         * the size of the stretch of the order between v2 and v1 plus the edges out of the vertices reached, not O(V + E)
+         * the first call on a graph without a kept order (new, or built with add_edge/add_edges out of order) pays one full traversal
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @param g the graph where the edge is added
+         * @return a pair where first of the pair is the edge_descriptor and second of the pair indicates whether it was added, false if it was already there
+         * @throws Boost's not_a_dag exception, and leaves the graph as it was, if the edge would close a cycle or if the graph already had one
+         */
+        friend std::pair<edge_descriptor, bool> add_edge_acyclic (vertex_descriptor v1, vertex_descriptor v2, basic_graph& g)
+        {
+            GraphStatsScope stats(g, op_add_edge_acyclic);
+            edge_descriptor e(v1, v2);
+            if(!g._ordered)
+            {
+                g.restore_order();
+            }
+            if(v1 == v2)
+            {
+                throw boost::not_a_dag(); //the graph is a DAG, so the self loop is not there already
+            }
+            if(std::max(v1, v2) >= g._vertices.size())
+            {
+                g.grow(std::max(v1, v2) + 1);
+            }
+            if(g._num_removed != 0)
+            {
+                g.revive(v1);
+                g.revive(v2);
+            }
+
+            row_type& row = g._targets[v1];
+            typename row_type::iterator p = std::lower_bound(row.begin(), row.end(), v2, TargetLess());
+            if(p != row.end() && *p == g.entry_of(v2))
+            {
+                return std::make_pair(e, false);
+            }
+            if(g._position[v1] > g._position[v2])
+            {
+                g.shift_order(v1, v2, stats);
+            }
+
+            g.put_entry(row, p, v2, stats);
+            ++g._num_edges;
+            ++g._in_degree[v2];
+            g.add_source(v1, v2, stats);
+            return std::make_pair(e, true);
+        }
+
+        // ---------
+        // add_edges
+        // ---------
+
+        /**
+         * add a range of edges at once
+         * the range is sorted and deduplicated by sort_edge_list, then each row is merged with the edges it
+         * already has in one pass, and each new row is built straight from its range: O(V + E) for rows of
+         * bounded degree instead of one binary search and insertion per edge
+         * the graph is enlarged to max(u, v) + 1 vertices like add_edge does
+         * load time on a 10M-edge input (uniform, 1.25M vertices, one core) is 6x to 8x better than add_edge on
+         * every pair, 1.0 s to 1.4 s against 8 s, short of 10x: sorting takes 0.6 s and each deque row allocates
+         * a 512 byte block however short it is, the first load pays the page faults for them
+         * @param g the graph where the edges are added
+         * @param first a forward iterator to std::pair<vertex_descriptor, vertex_descriptor>
+         * @param last end of the range
+         * @return the number of edges that were not already in the graph
+         */
+        template <typename FI>
+        friend edges_size_type add_edges (basic_graph& g, FI first, FI last)
+        {
+            GraphStatsScope stats(g, op_add_edges);
+            std::vector<std::size_t> offsets;
+            std::vector<vertex_descriptor> targets;
+            vertices_size_type n = sort_edge_list(first, last, g._vertices.size(), offsets, targets);
+            stats.examine_edges(targets.size());
+            g.grow(n, false); //merge_rows builds the new rows
+            for(vertex_descriptor v = 0; v < n && g._num_removed != 0; ++v)
+            {
+                if(offsets[v] != offsets[v + 1])
+                {
+                    g.revive(v);
+                }
+                for(std::size_t i = offsets[v]; i != offsets[v + 1]; ++i)
+                {
+                    g.revive(targets[i]);
+                }
+            }
+
+            if(g._ordered)
+            {
+                for(vertex_descriptor v = 0; v < n && g._ordered; ++v)
+                {
+                    for(std::size_t i = offsets[v]; i != offsets[v + 1]; ++i)
+                    {
+                        if(g._position[v] >= g._position[targets[i]])
+                        {
+                            g.forget_order();
+                            break;
+                        }
+                    }
+                }
+            }
+
+            //the same edges turned around, merged into the rows of in-neighbours the same way
+            std::vector< std::pair<vertex_descriptor, vertex_descriptor> > reversed;
+            if(is_bidirectional)
+            {
+                reversed.reserve(targets.size());
+                for(vertex_descriptor v = 0; v < n; ++v)
+                {
+                    for(std::size_t i = offsets[v]; i != offsets[v + 1]; ++i)
+                    {
+                        reversed.push_back(std::make_pair(targets[i], v));
+                    }
+                }
+            }
+
+            g.stamp(targets);
+            edges_size_type added = g.merge_rows(g._targets, offsets, targets, true, stats);
+            g._num_edges += added;
+            if(is_bidirectional)
+            {
+                sort_edge_list(reversed.begin(), reversed.end(), n, offsets, targets);
+                g.stamp(targets);
+                g.merge_rows(g._sources, offsets, targets, false, stats);
+            }
+            return added;
+        }
+
+        // ----------
+        // add_vertex
+        // ----------
+
+        /**
+         * add a vertex_descriptor to the graph
+         * @param g the graph where vertex_descriptor is added
+         * @return the vertex_descriptor added
+         */
+        friend vertex_descriptor add_vertex (basic_graph& g) 
+        {
+            g.grow(g._vertices.size() + 1);
+            return g._vertices.back();
+        }
+
+        // ------------
+        // clear_vertex
+        // ------------
+
+        /**
+         * remove every edge into and out of a vertex, the vertex stays
+         * O(1) amortized on top of the walk of v's own rows, which the edges in them paid for when they were added:
+         * the edges into v are dropped by bumping v's generation, their entries in the other rows become tombstones
+         * @param v a vertex_descriptor
+         * @param g the graph
+         */
+        friend void clear_vertex (vertex_descriptor v, basic_graph& g)
+        {
+            GraphStatsScope stats(g, op_clear_vertex);
+            if(v >= g._vertices.size() || g._vertices[v] == null_vertex())
+            {
+                return;
+            }
+            row_type& row = g._targets[v];
+            stats.examine_edges(row.size());
+            edges_size_type in = g._in_degree[v];
+            edges_size_type out = 0;
+            edges_size_type loop = 0;
+            for(typename row_type::const_iterator t = row.begin(); t != row.end(); ++t)
+            {
+                if(g.live(*t))
+                {
+                    ++out;
+                    --g._in_degree[*t & target_mask];
+                    loop += (*t & target_mask) == v;
+                }
+            }
+            g._num_edges -= out + in - loop;
+            g._num_stale -= row.size() - out;
+            g.release_row(row);
+            if(is_bidirectional)
+            {
+                row_type& in_row = g._sources[v];
+                stats.examine_edges(in_row.size());
+                g._num_stale -= in_row.size() - in;
+                g.release_row(in_row);
+            }
+
+            if(g._generation[v] == max_generation)
+            {
+                g.reclaim(stats);
+            }
+            ++g._generation[v]; //the entries of the edges into v, and with bidirectionalS of the edges out of it, are stale from now on
+            g._stamped = true;
+            g._in_degree[v] = 0;
+            g._num_stale += in - loop;
+            if(is_bidirectional)
+            {
+                g._num_stale += out - loop;
+            }
+            g.reclaim_if_sparse(stats);
+        }
+
+        // -------
+        // compact
+        // -------
+
+        /**
+         * renumber the vertices left by remove_vertex densely, keeping their relative order, and take the
+         * tombstones out of the rows, O(V + E) and the number of tombstones
+         * every vertex_descriptor and iterator into the graph is invalidated, the remapping says what became of them
+         * the rows stay sorted as they are since the renumbering is increasing
+         * @param g the graph
+         * @return remap, remap[v] is v's new vertex_descriptor, null_vertex() if v was removed
+         */
+        friend std::vector<vertex_descriptor> compact (basic_graph& g)
+        {
+            GraphStatsScope stats(g, op_compact);
+            stats.visit_vertices(g._vertices.size());
+            std::vector<vertex_descriptor> remap(g._vertices.size(), null_vertex());
+            vertex_descriptor next = 0;
+            for(vertex_descriptor v = 0; v < g._vertices.size(); ++v)
+            {
+                if(g._vertices[v] != null_vertex())
+                {
+                    remap[v] = next++;
+                }
+            }
+            if(g._num_stale != 0 || g._stamped)
+            {
+                g.reclaim(stats);
+            }
+            if(g._num_removed == 0)
+            {
+                return remap;
+            }
+
+            //no entry is left for a removed vertex, its generation was bumped when it was removed
+            stats.examine_edges(is_bidirectional ? 2 * g._num_edges : g._num_edges);
+            for(vertex_descriptor v = 0; v < g._vertices.size(); ++v)
+            {
+                if(remap[v] == null_vertex())
+                {
+                    continue;
+                }
+                renumber_row(g._targets[v], remap);
+                g._targets[remap[v]].swap(g._targets[v]);
+                g._vertices[remap[v]] = remap[v];
+                g._in_degree[remap[v]] = g._in_degree[v];
+                if(is_bidirectional)
+                {
+                    renumber_row(g._sources[v], remap);
+                    g._sources[remap[v]].swap(g._sources[v]);
+                }
+            }
+            g._vertices.resize(next);
+            g._generation.resize(next);
+            g._in_degree.resize(next);
+            g._targets.resize(next, g.empty_row());
+            if(is_bidirectional)
+            {
+                g._sources.resize(next, g.empty_row());
+            }
+            if(g._ordered)
+            {
+                std::size_t i = 0;
+                for(std::size_t p = 0; p < g._order.size(); ++p)
+                {
+                    if(remap[g._order[p]] != null_vertex())
+                    {
+                        g._order[i] = remap[g._order[p]];
+                        g._position[g._order[i]] = i;
+                        ++i;
+                    }
+                }
+                g._order.resize(next);
+                g._position.resize(next);
+            }
+            g._num_removed = 0;
+            assert(g.valid());
+            return remap;
+        }
+
+        // -----------
+        // remove_edge
+        // -----------
+
+        /**
+         * remove an edge if it is there, a kept topological order stays valid
+         * O(log deg(v1)) to find the edge, plus O(log in-degree(v2)) with boost::bidirectionalS, and O(1) amortized
+         * to remove it: its entry is marked, nothing in the row moves
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @param g the graph
+         */
+        friend void remove_edge (vertex_descriptor v1, vertex_descriptor v2, basic_graph& g)
+        {
+            GraphStatsScope stats(g, op_remove_edge);
+            if(std::max(v1, v2) >= g._vertices.size())
+            {
+                return;
+            }
+            row_type& row = g._targets[v1];
+            typename row_type::iterator p = std::lower_bound(row.begin(), row.end(), v2, TargetLess());
+            if(p == row.end() || *p != g.entry_of(v2))
+            {
+                return;
+            }
+            *p |= removed_edge;
+            --g._num_edges;
+            --g._in_degree[v2];
+            ++g._num_stale;
+            if(is_bidirectional)
+            {
+                row_type& in_row = g._sources[v2];
+                *std::lower_bound(in_row.begin(), in_row.end(), v1, TargetLess()) |= removed_edge;
+                ++g._num_stale;
+            }
+            g.reclaim_if_sparse(stats);
+        }
+
+        /**
+         * remove an edge if it is there
+         * @param e an edge_descriptor
+         * @param g the graph
+         */
+        friend void remove_edge (edge_descriptor e, basic_graph& g)
+        {
+            remove_edge(e._source, e._target, g);
+        }
+
+        // -------------
+        // remove_vertex
+        // -------------
+
+        /**
+         * remove a vertex and its edges, as clear_vertex, and leave a tombstone in its place
+         * the other vertex_descriptors stay valid, vertices() and num_vertices() no longer count v, and
+         * the tombstone is O(1) on top of clearing the edges, the slot is reused only by compact()
+         * @param v a vertex_descriptor
+         * @param g the graph
+         */
+        friend void remove_vertex (vertex_descriptor v, basic_graph& g)
+        {
+            GraphStatsScope stats(g, op_remove_vertex);
+            if(v >= g._vertices.size() || g._vertices[v] == null_vertex())
+            {
+                return;
+            }
+            clear_vertex(v, g);
+            g._vertices[v] = null_vertex(); //an isolated vertex can stay anywhere in a kept order
+            ++g._num_removed;
+        }
+
+        // -----------------
+        // adjacent_vertices
+        // -----------------
+
+        /**
+         * adjacent_vertices function
+         * the adjacent vertices are visited in increasing vertex_descriptor order
+         * @param v a vertex_descriptor
+         * @param g the graph where the vertex_descriptor is
+         * @return a pair of adjacency_iterators, where the first iterator can travel to the second one the eventually visit all the adjacent vertices of the vertex_descriptor
+         */
+        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor v, const basic_graph& g) 
+        {
+            const row_type& row = g._targets[v];
+            const vertices_type* generation = g._num_stale == 0 ? 0 : &g._generation;
+            return std::make_pair(adjacency_iterator(row.begin(), row.size(), generation), adjacency_iterator(row.end(), 0, generation));
+        }
+
+        // ----
+        // edge
+        // ----
+
+        /**
+         * edge function
+         * binary search in v1's sorted row, O(log deg(v1))
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @param g the graph where the vertex_descriptor is
+         * @return a pair, where first is the edge_descriptor between the vertices, second is a bool indicates whether the edge_descriptor exists in the graph
+         */
+        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor v1, vertex_descriptor v2, const basic_graph& g) 
+        {
+            edge_descriptor e(v1, v2);
+            if(std::max(v1, v2) >= g._targets.size())
+            {
+                return std::make_pair(e, false);
+            }
+            const row_type& row = g._targets[v1];
+            typename row_type::const_iterator p = std::lower_bound(row.begin(), row.end(), v2, TargetLess());
+            return std::make_pair(e, p != row.end() && *p == g.entry_of(v2));
+        }
+
+        // -----
+        // edges
+        // -----
+
+        /**
+         * edges function
+         * the edges are visited by increasing source, then by increasing target
+         * @param g a Graph
+         * @return a pair of edge_iterator in which the first can travel to the second one the eventually visits all the edges in the given graph
+         */
+        friend std::pair<edge_iterator, edge_iterator> edges (const basic_graph& g) 
+        {
+            edge_iterator b(&g, 0);
+            edge_iterator e(&g, g._targets.size());
+            return std::make_pair(b, e);
+        }
+
+        // ---------
+        // in_degree
+        // ---------
+
+        /**
+         * in_degree function, only with boost::bidirectionalS
+         * @param v a vertex_descriptor
+         * @param g a Graph
+         * @return the number of edges into v, O(1)
+         */
+        friend degree_size_type in_degree (vertex_descriptor v, const basic_graph& g)
+        {
+            static_assert(is_bidirectional, "in_degree needs a basic_graph with boost::bidirectionalS");
+            return g._in_degree[v];
+        }
+
+        // --------
+        // in_edges
+        // --------
+
+        /**
+         * in_edges function, only with boost::bidirectionalS
+         * the edges are visited by increasing source
+         * @param v a vertex_descriptor
+         * @param g a Graph
+         * @return a pair of in_edge_iterator over the edges into v, O(in-degree) to walk instead of a scan of every edge
+         */
+        friend std::pair<in_edge_iterator, in_edge_iterator> in_edges (vertex_descriptor v, const basic_graph& g)
+        {
+            static_assert(is_bidirectional, "in_edges needs a basic_graph with boost::bidirectionalS");
+            InEdgeMaker f = {v};
+            std::pair<inv_adjacency_iterator, inv_adjacency_iterator> p = inv_adjacent_vertices(v, g);
+            return std::make_pair(in_edge_iterator(p.first, f), in_edge_iterator(p.second, f));
+        }
+
+        // ---------------------
+        // inv_adjacent_vertices
+        // ---------------------
+
+        /**
+         * inv_adjacent_vertices function, only with boost::bidirectionalS
+         * the in-neighbours are visited in increasing vertex_descriptor order
+         * @param v a vertex_descriptor
+         * @param g a Graph
+         * @return a pair of inv_adjacency_iterator over the vertices with an edge into v
+         */
+        friend std::pair<inv_adjacency_iterator, inv_adjacency_iterator> inv_adjacent_vertices (vertex_descriptor v, const basic_graph& g)
+        {
+            static_assert(is_bidirectional, "inv_adjacent_vertices needs a basic_graph with boost::bidirectionalS");
+            const row_type& row = g._sources[v];
+            const vertices_type* generation = g._num_stale == 0 ? 0 : &g._generation;
+            return std::make_pair(inv_adjacency_iterator(row.begin(), row.size(), generation), inv_adjacency_iterator(row.end(), 0, generation));
+        }
+
+        // ---------
+        // num_edge
+        // ---------
+
+        /**
+         * num_edge function
+         * @param g a Graph
+         * @return the number of edges in the given graph
+         */
+        friend edges_size_type num_edges (const basic_graph& g) 
+        {
+            return g._num_edges;
+        }
+
+        // ------------
+        // num_vertices
+        // ------------
+
+        /**
+         * num_vertices function
+         * @param g a Graph
+         * @return the number of vertices in the given graph, the removed ones not counted
+         */
+        friend vertices_size_type num_vertices (const basic_graph& g) 
+        {
+            return g._vertices.size() - g._num_removed;
+        }
+
+        // ------
+        // source
+        // ------
+
+        /**
+         * source function
+         * @param r an edge_descriptor
+         * @param g a Graph
+         * @return the source vertex_descriptor of a given edge_descriptor in the given graph
+         */
+        friend vertex_descriptor source (edge_descriptor e, const basic_graph&) 
+        {
+            return e._source;
+        }
+
+        // ------
+        // target
+        // ------
+
+        /**
+         * target function
+         * @param e an edge_descriptor
+         * @param g a Graph
+         * @return the target vertex_descriptor of a given edge_descriptor in the given graph
+         */
+        friend vertex_descriptor target (edge_descriptor e, const basic_graph&) 
+        {
+            return e._target;
+        }
+
+        // ------
+        // vertex
+        // ------
+
+        /**
+         * vertex function
+         * @param nth integral value represents the n term index of the vertex, below vertex_index_bound(g)
+         * @param g a Graph
+         * @return the nth vertex_descriptor of the graph, null_vertex() if it was removed
+         */
+        friend vertex_descriptor vertex (vertices_size_type nth, const basic_graph& g) 
+        {
+            return g._vertices[nth];
+        }
+
+        // ------------------
+        // vertex_index_bound
+        // ------------------
+
+        /**
+         * vertex_index_bound function
+         * @param g a Graph
+         * @return one past the largest vertex_descriptor, what a map indexed by vertex_descriptor has to hold, removed vertices included
+         */
+        friend vertices_size_type vertex_index_bound (const basic_graph& g)
+        {
+            return g._vertices.size();
+        }
+
+        // --------
+        // vertices
+        // --------
+
+        /**
+         * vertices function
+         * @param g a Graph
+         * @return a pair of vertex_iterator in which the first can travel to the second one the eventually visits all the vertices in the given graph
+         */
+        friend std::pair<vertex_iterator, vertex_iterator> vertices (const basic_graph& g) 
+        {
+            return std::make_pair(vertex_iterator(g._vertices.begin(), g._vertices.end()), vertex_iterator(g._vertices.end(), g._vertices.end()));
+        }
+
+    private:
+        // ----
+        // data
+        // ----
+
+        vertices_type _vertices; /*!< container of the vertex_descriptors, _vertices[v] is v or null_vertex() once v is removed */
+
+        vertices_size_type _num_removed; /*!< number of null_vertex() tombstones in _vertices */
+
+        rows_type _targets; /*!< per-source row entries sorted by target, also the index of the edges */
+
+        rows_type _sources; /*!< per-target row entries sorted by source, only with boost::bidirectionalS, empty otherwise */
+
+        vertices_type _generation; /*!< _generation[v] is stamped on the entries for v, an entry stands for an edge while the two match */
+
+        vertices_type _in_degree; /*!< _in_degree[v] is the number of edges into v */
+
+        edges_size_type _num_edges; /*!< number of edges over all the rows */
+
+        edges_size_type _num_stale; /*!< number of entries in the rows that stand for no edge, the tombstones */
+
+        bool _stamped; /*!< whether a generation is not 0 since the last reclaim, the entries are not all bare targets then */
+
+        vertices_type _order; /*!< the vertices in a topological order, kept by add_edge_acyclic, empty unless _ordered */
+
+        vertices_type _position; /*!< _position[v] is the index of v in _order */
+
+        bool _ordered; /*!< whether _order is a topological order of the graph as it is */
+
+#ifdef GRAPH_STATS
+        mutable GraphStats _stats; /*!< what the operations on this graph did, a copy of the graph starts from zero */
+#endif
+
+        // ----
+        // grow
+        // ----
+
+        /**
+         * enlarge the graph to n vertices, numbering the new ones consecutively
+         * @param n the new number of vertices
+         * @param rows whether to add the new, empty, rows too, add_edges leaves them to merge_rows
+         */
+        void grow (vertices_size_type n, bool rows = true)
+        {
+            if(n <= _vertices.size())
+            {
+                return;
+            }
+            GraphStatsScope stats(*this, op_grow);
+            std::size_t grown = n - _vertices.size();
+            stats.visit_vertices(grown);
+            assert(n <= target_mask);
+            std::size_t before = GRAPH_STATS_BYTES(container_bytes(_vertices) + container_bytes(_targets) + container_bytes(_sources) + container_bytes(_generation) + container_bytes(_in_degree) + container_bytes(_order) + container_bytes(_position));
+            while(_vertices.size() < n)
+            {
+                if(_ordered)
+                {
+                    //a vertex without edges can go anywhere in the order, the end is cheapest
+                    _position.push_back(_order.size());
+                    _order.push_back(_vertices.size());
+                }
+                _vertices.push_back(_vertices.size());
+            }
+            _generation.resize(n, 0);
+            _in_degree.resize(n, 0);
+            if(!rows)
+            {
+                stats.allocate(before, GRAPH_STATS_BYTES(container_bytes(_vertices) + container_bytes(_targets) + container_bytes(_sources) + container_bytes(_generation) + container_bytes(_in_degree) + container_bytes(_order) + container_bytes(_position)));
+                return;
+            }
+            _targets.resize(n, empty_row());
+            if(is_bidirectional)
+            {
+                _sources.resize(n, empty_row());
+            }
+            //the new rows count too, the deque ones allocate even when empty
+            stats.allocate(before, GRAPH_STATS_BYTES(container_bytes(_vertices) + container_bytes(_targets) + container_bytes(_sources) + container_bytes(_generation) + container_bytes(_in_degree) + container_bytes(_order) + container_bytes(_position)
+                                                     + (is_bidirectional ? 2 : 1) * grown * container_bytes(_targets.back())));
+        }
+
+        // ------
+        // revive
+        // ------
+
+        /**
+         * bring a removed vertex back, without edges, when an edge is added to it
+         * @param v a vertex_descriptor below _vertices.size()
+         */
+        void revive (vertex_descriptor v)
+        {
+            if(_vertices[v] == null_vertex())
+            {
+                _vertices[v] = v;
+                --_num_removed;
+            }
+        }
+
+        // --------
+        // entry_of
+        // --------
+
+        /**
+         * @param v a vertex_descriptor below _vertices.size()
+         * @return the row entry that stands for an edge to, or from, v as long as v's generation does not change
+         */
+        vertex_descriptor entry_of (vertex_descriptor v) const
+        {
+            return v | (_generation[v] << generation_shift);
+        }
+
+        // ----
+        // live
+        // ----
+
+        /**
+         * @param entry a row entry
+         * @return whether the entry stands for an edge, neither removed nor dropped with its vertex's generation
+         */
+        bool live (vertex_descriptor entry) const
+        {
+            return (entry >> generation_shift) == _generation[entry & target_mask];
+        }
+
+        // ---------
+        // put_entry
+        // ---------
+
+        /**
+         * put the entry of v into a sorted row, over the tombstone an earlier edge left for v if there is one
+         * @param row a sorted row with no live entry for v
+         * @param p the lower bound of v in row
+         * @param v a vertex_descriptor
+         * @param stats the scope of the operation adding the edge, told how much the row grew
+         */
+        void put_entry (row_type& row, typename row_type::iterator p, vertex_descriptor v, GraphStatsScope& stats)
+        {
+            if(p != row.end() && (*p & target_mask) == v)
+            {
+                *p = entry_of(v);
+                --_num_stale;
+                return;
+            }
+            std::size_t before = GRAPH_STATS_BYTES(container_bytes(row));
+            row.insert(p, entry_of(v));
+            stats.allocate(before, GRAPH_STATS_BYTES(container_bytes(row)));
+        }
+
+        // -----
+        // stamp
+        // -----
+
+        /**
+         * turn the vertices of sorted rows into the entries that stand for them, nothing to do unless a generation was bumped
+         * @param vertices rows of vertex_descriptors below _vertices.size(), back to back
+         */
+        void stamp (std::vector<vertex_descriptor>& vertices) const
+        {
+            if(_stamped)
+            {
+                for(std::size_t i = 0; i < vertices.size(); ++i)
+                {
+                    vertices[i] = entry_of(vertices[i]);
+                }
+            }
+        }
+
+        // -------
+        // reclaim
+        // -------
+
+        /**
+         * take the tombstones out of every row and put every generation back to 0, O(V + E) and the number of tombstones
+         * @param stats the scope of the removal or compaction that needed it, told the entries walked
+         */
+        void reclaim (GraphStatsScope& stats)
+        {
+            for(int pass = 0; pass < (is_bidirectional ? 2 : 1); ++pass)
+            {
+                rows_type& rows = pass == 0 ? _targets : _sources;
+                for(typename rows_type::iterator r = rows.begin(); r != rows.end(); ++r)
+                {
+                    stats.examine_edges(r->size());
+                    typename row_type::iterator out = r->begin();
+                    for(typename row_type::const_iterator e = r->begin(); e != r->end(); ++e)
+                    {
+                        if(live(*e))
+                        {
+                            *out++ = *e & target_mask; //the generations are all 0 once done
+                        }
+                    }
+                    r->erase(out, r->end());
+                }
+            }
+            std::fill(_generation.begin(), _generation.end(), 0);
+            _num_stale = 0;
+            _stamped = false;
+        }
+
+        /**
+         * reclaim once the tombstones outnumber both the edges and the vertices, so its cost is paid by the removals that made them
+         * @param stats the scope of the removal
+         */
+        void reclaim_if_sparse (GraphStatsScope& stats)
+        {
+            if(_num_stale > _num_edges && _num_stale > _vertices.size())
+            {
+                reclaim(stats);
+            }
+        }
+
+        // ------------
+        // renumber_row
+        // ------------
+
+        /**
+         * replace every vertex_descriptor of a row by its new one, an increasing remap keeps the row sorted
+         * @param row a sorted row of vertices that are not removed, without tombstones and generations
+         * @param remap the new vertex_descriptors
+         */
+        static void renumber_row (row_type& row, const std::vector<vertex_descriptor>& remap)
+        {
+            for(typename row_type::iterator t = row.begin(); t != row.end(); ++t)
+            {
+                *t = remap[*t];
+            }
+        }
+
+        // -----------
+        // release_row
+        // -----------
+
+        /**
+         * empty a row and give its memory back
+         * @param row a row of the graph
+         */
+        void release_row (row_type& row)
+        {
+            row_type empty = empty_row();
+            row.swap(empty);
+        }
+
+        // ----------
+        // add_source
+        // ----------
+
+        /**
+         * record u as an in-neighbour of v after the edge u -> v was added, nothing without boost::bidirectionalS
+         * @param u the source of the new edge
+         * @param v the target of the new edge
+         * @param stats the scope of the operation adding the edge, told how much the row grew
+         */
+        void add_source (vertex_descriptor u, vertex_descriptor v, GraphStatsScope& stats)
+        {
+            if(is_bidirectional)
+            {
+                row_type& row = _sources[v];
+                put_entry(row, std::lower_bound(row.begin(), row.end(), u, TargetLess()), u, stats);
+            }
+        }
+
+        // ----------
+        // merge_rows
+        // ----------
+
+        /**
+         * merge compressed sparse rows, as sort_edge_list makes them, into sorted rows
+         * the rows past the end of rows are appended, each constructed from its range, which costs a fraction
+         * of filling a default constructed one, and a tombstone for a vertex of the range is replaced
+         * @param rows _targets or _sources, at most as many rows as offsets has
+         * @param offsets the row offsets
+         * @param entries the rows, back to back, sorted and duplicate free, stamped
+         * @param out whether rows is _targets, the entries then count in the in-degrees of their targets
+         * @param stats the scope of the operation adding the edges, told how much the rows grew
+         * @return the number of entries that were not already in rows
+         */
+        edges_size_type merge_rows (rows_type& rows, const std::vector<std::size_t>& offsets, const std::vector<vertex_descriptor>& entries, bool out, GraphStatsScope& stats)
+        {
+            edges_size_type added = 0;
+            row_type merged = empty_row();
+            for(std::size_t v = 0; v + 1 < offsets.size(); ++v)
+            {
+                typename std::vector<vertex_descriptor>::const_iterator b = entries.begin() + offsets[v];
+                typename std::vector<vertex_descriptor>::const_iterator e = entries.begin() + offsets[v + 1];
+                if(v >= rows.size())
+                {
+                    rows.push_back(row_type(b, e, merged.get_allocator()));
+                    stats.allocate(0, GRAPH_STATS_BYTES(container_bytes(rows.back())));
+                }
+                else if(b == e)
+                {
+                    continue;
+                }
+                else if(rows[v].empty())
+                {
+                    std::size_t before = GRAPH_STATS_BYTES(container_bytes(rows[v]));
+                    rows[v].assign(b, e);
+                    stats.allocate(before, GRAPH_STATS_BYTES(container_bytes(rows[v])));
+                }
+                else
+                {
+                    row_type& row = rows[v];
+                    std::size_t before = GRAPH_STATS_BYTES(container_bytes(row));
+                    merged.clear();
+                    typename row_type::const_iterator r = row.begin();
+                    for(; b != e; ++b)
+                    {
+                        vertex_descriptor t = *b & target_mask;
+                        for(; r != row.end() && (*r & target_mask) < t; ++r)
+                        {
+                            merged.push_back(*r);
+                        }
+                        if(r != row.end() && (*r & target_mask) == t)
+                        {
+                            if(live(*r))
+                            {
+                                merged.push_back(*r++);
+                                continue;
+                            }
+                            ++r; //the tombstone gives way to the new entry
+                            --_num_stale;
+                        }
+                        merged.push_back(*b);
+                        ++added;
+                        if(out)
+                        {
+                            ++_in_degree[t];
+                        }
+                    }
+                    merged.insert(merged.end(), r, row.cend());
+                    row.swap(merged);
+                    stats.allocate(before, GRAPH_STATS_BYTES(container_bytes(row)));
+                    continue;
+                }
+                added += e - b;
+                for(; out && b != e; ++b)
+                {
+                    ++_in_degree[*b & target_mask];
+                }
+            }
+            return added;
+        }
+
+        // -------------
+        // restore_order
+        // -------------
+
+        /**
+         * compute a topological order of the whole graph, O(V + E)
+         * @throws Boost's not_a_dag exception if the graph has a cycle
+         */
+        void restore_order ()
+        {
+            std::vector<vertex_descriptor> postorder;
+            postorder.reserve(_vertices.size());
+            if(dfs_postorder(*this, std::back_inserter(postorder)))
+            {
+                throw boost::not_a_dag();
+            }
+            _order.assign(postorder.rbegin(), postorder.rend());
+            for(vertex_descriptor v = 0; v < _vertices.size() && _order.size() != _vertices.size(); ++v)
+            {
+                if(_vertices[v] == null_vertex())
+                {
+                    _order.push_back(v); //the removed vertices are kept in the order too, at the end, they have no edges
+                }
+            }
+            _position.resize(_order.size());
+            for(std::size_t i = 0; i < _order.size(); ++i)
+            {
+                _position[_order[i]] = i;
+            }
+            _ordered = true;
+        }
+
+        // ------------
+        // forget_order
+        // ------------
+
+        /**
+         * drop the kept order once an edge contradicts it, add_edge_acyclic computes it again when needed
+         */
+        void forget_order ()
+        {
+            _ordered = false;
+            _order.clear();
+            _position.clear();
+        }
+
+        // -----------
+        // shift_order
+        // -----------
+
+        /**
+         * repair the order for a new edge u -> v with v before u
+         * the vertices reachable from v without going past u's position are moved, in the order they had, right after u
+         * any edge out of a moved vertex lands on a moved vertex or past u, so the order stays topological
+         * @param u the source of the new edge
+         * @param v the target of the new edge
+         * @param stats the scope of the operation adding the edge, told the vertices reached and the edges out of them
+         * @throws Boost's not_a_dag exception, without touching the order, if u is reachable from v
+         */
+        void shift_order (vertex_descriptor u, vertex_descriptor v, GraphStatsScope& stats)
+        {
+            std::size_t lb = _position[v];
+            std::size_t ub = _position[u];
+            std::vector<char> reached(ub - lb, 0); //indexed by position - lb, u's own position is never marked
+            std::vector<vertex_descriptor> s(1, v);
+            reached[0] = 1;
+            while(!s.empty())
+            {
+                std::pair<adjacency_iterator, adjacency_iterator> row = adjacent_vertices(s.back(), *this);
+                stats.visit_vertices(1);
+                stats.examine_edges(_targets[s.back()].size());
+                s.pop_back();
+                for(adjacency_iterator t = row.first; t != row.second; ++t)
+                {
+                    std::size_t p = _position[*t];
+                    if(p == ub)
+                    {
+                        throw boost::not_a_dag();
+                    }
+                    if(p < ub && !reached[p - lb])
+                    {
+                        reached[p - lb] = 1;
+                        s.push_back(*t);
+                    }
+                }
+            }
+
+            std::vector<vertex_descriptor> moved;
+            std::size_t next = lb;
+            for(std::size_t p = lb; p <= ub; ++p)
+            {
+                vertex_descriptor w = _order[p];
+                if(p < ub && reached[p - lb])
+                {
+                    moved.push_back(w);
+                }
+                else
+                {
+                    _order[next] = w;
+                    _position[w] = next++;
+                }
+            }
+            for(std::size_t i = 0; i < moved.size(); ++i)
+            {
+                _order[next] = moved[i];
+                _position[moved[i]] = next++;
+            }
+        }
+
+        // ---------
+        // empty_row
+        // ---------
+
+        /**
+         * @return a row with no targets that allocates from the graph's allocator
+         */
+        row_type empty_row () const
+        {
+            typedef typename std::allocator_traits<Alloc>::template rebind_alloc<vertex_descriptor> row_alloc;
+            return row_type(typename row_type::allocator_type(row_alloc(get_allocator())));
+        }
+
+        // -----
+        // valid
+        // -----
+
+        /**
+         * valid function
+         */
+        bool valid () const 
+        {
+            return _vertices.size() == _targets.size() && (!is_bidirectional || _sources.size() == _targets.size()) && _generation.size() == _vertices.size() && _in_degree.size() == _vertices.size()
+                && (!_ordered || _order.size() == _vertices.size()) && _num_removed <= _vertices.size();
+        }
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         *  default constructor
+         */
+        basic_graph () : _vertices(), _num_removed(0), _targets(), _sources(), _generation(), _in_degree(), _num_edges(0), _num_stale(0), _stamped(false), _order(), _position(), _ordered(false)
+        {
+            assert(valid());
+        }
+
+        /**
+         * constructor
+         * @param a the allocator of all the internal containers, rows included
+         */
+        explicit basic_graph (const Alloc& a) : _vertices(a), _num_removed(0), _targets(a), _sources(a), _generation(a), _in_degree(a), _num_edges(0), _num_stale(0), _stamped(false), _order(a), _position(a), _ordered(false)
+        {
+            assert(valid());
+        }
+
+        /**
+         * bulk constructor, same graph as add_edge called on every pair of the range but built like add_edges does it
+         * @param first a forward iterator to std::pair<vertex_descriptor, vertex_descriptor>
+         * @param last end of the range
+         * @param n the minimum number of vertices, the graph has max(n, max(u, v) + 1) vertices
+         * @param a the allocator of all the internal containers, rows included
+         */
+        template <typename FI>
+        basic_graph (FI first, FI last, vertices_size_type n = 0, const Alloc& a = Alloc()) : _vertices(a), _num_removed(0), _targets(a), _sources(a), _generation(a), _in_degree(a), _num_edges(0), _num_stale(0), _stamped(false), _order(a), _position(a), _ordered(false)
+        {
+            grow(n, false); //add_edges builds the rows
+            add_edges(*this, first, last);
+            assert(valid());
+        }
+
+        /**
+         * kept_order function, used by topological_sort
+         * @param g a basic_graph
+         * @param x an output iterator that receives the vertices, sinks first like topological_sort, if the graph keeps an order
+         * @return whether the graph keeps a topological order (see add_edge_acyclic), nothing is written otherwise
+         */
+        template <typename OI>
+        friend bool kept_order (const basic_graph& g, OI x)
+        {
+            if(!g._ordered)
+            {
+                return false;
+            }
+            if(g._num_removed == 0)
+            {
+                std::copy(g._order.rbegin(), g._order.rend(), x);
+            }
+            else
+            {
+                for(typename vertices_type::const_reverse_iterator p = g._order.rbegin(); p != g._order.rend(); ++p)
+                {
+                    if(g._vertices[*p] != null_vertex())
+                    {
+                        *x = *p;
+                        ++x;
+                    }
+                }
+            }
+            return true;
+        }
+
+#ifdef GRAPH_STATS
+        /**
+         * graph_stats_of function, used by GraphStatsScope and graph_stats
+         * @param g a basic_graph
+         * @return the graph's own counters
+         */
+        friend GraphStats& graph_stats_of (const basic_graph& g)
+        {
+            return g._stats;
+        }
+#endif
+
+        /**
+         * get_allocator function
+         * @return the allocator the graph was constructed with
+         */
+        Alloc get_allocator () const
+        {
+            return Alloc(_vertices.get_allocator());
+        }
+
+        /**
+         * equal operator
+         * two graphs are equal when they have the same vertices and the same set of edges, whatever order the edges were added
+         * and removed in, the tombstones do not count
+         * @lhs a Graph
+         * @rhs a Graph
+         */
+        friend bool operator == (const basic_graph& lhs, const basic_graph& rhs) 
+        {
+            if(lhs._vertices != rhs._vertices || lhs._num_edges != rhs._num_edges)
+            {
+                return false;
+            }
+            for(vertex_descriptor v = 0; v < lhs._targets.size(); ++v)
+            {
+                std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, lhs);
+                std::pair<adjacency_iterator, adjacency_iterator> q = adjacent_vertices(v, rhs);
+                for(; p.first != p.second && q.first != q.second && *p.first == *q.first; ++p.first, ++q.first)
+                {}
+                if(p.first != p.second || q.first != q.second)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Default copy, destructor, and copy assignment
+        // basic_graph  (const basic_graph&);
+        // ~basic_graph ();
+        // basic_graph& operator = (const basic_graph&);
+
+};
+
+// -----
+// Graph
+// -----
+
+typedef basic_graph<> Graph;
+
+
+// ---------------
+// CsrEdgeIterator
+// ---------------
+
+/**
+ * walks the edges of a compressed sparse row layout, by increasing source
+ * works over any pair of contiguous offset and target arrays
+ */
+class CsrEdgeIterator
+{
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef EdgeDescriptor value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const EdgeDescriptor* pointer;
+        typedef EdgeDescriptor reference;
+
+    /**
+     * default constructor
+     */
+    CsrEdgeIterator() : _offsets(0), _targets(0), _source(0), _pos(0), _end(0)
+    {}
+
+    /**
+     * constructor
+     * @param offsets the row offsets, offsets[v] is where v's targets start
+     * @param targets the packed targets
+     * @param pos the index in targets of the edge pointed at
+     * @param end the number of edges
+     * @param vertices the number of vertices, offsets holds vertices + 1 entries
+     */
+    CsrEdgeIterator(const std::size_t* offsets, const std::size_t* targets, std::size_t pos, std::size_t end, std::size_t vertices) :
+        _offsets(offsets), _targets(targets), _source(0), _pos(pos), _end(end)
+    {
+        if(_pos < _end)
+        {
+            _source = std::upper_bound(_offsets, _offsets + vertices + 1, _pos) - _offsets - 1;
+            while(_offsets[_source + 1] <= _pos)
+            {
+                ++_source;
+            }
+        }
+    }
+
+    /**
+     * dereference operator
+     * @return the edge_descriptor currently pointed at
+     */
+    reference operator * () const
+    {
+        return EdgeDescriptor(_source, _targets[_pos]);
+    }
+
+    /**
+     * pre-increment operator, moves to the next target and then to the next non-empty row
+     * @return this CsrEdgeIterator
+     */
+    CsrEdgeIterator& operator ++ ()
+    {
+        if(++_pos < _end)
+        {
+            while(_offsets[_source + 1] <= _pos)
+            {
+                ++_source;
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * post-increment operator
+     * @return a copy of this CsrEdgeIterator before it was incremented
+     */
+    CsrEdgeIterator operator ++ (int)
+    {
+        CsrEdgeIterator x = *this;
+        ++*this;
+        return x;
+    }
+
+    /**
+     * == operator for CsrEdgeIterator
+     * @param lhs a CsrEdgeIterator
+     * @param rhs a CsrEdgeIterator
+     * @return a bool that indicates whether the CsrEdgeIterators point at the same edge
+     */
+    friend bool operator == (const CsrEdgeIterator& lhs, const CsrEdgeIterator& rhs)
+    {
+        return lhs._pos == rhs._pos;
+    }
+
+    private:
+        const std::size_t* _offsets; /*!< row offsets */
+        const std::size_t* _targets; /*!< packed targets */
+        std::size_t _source; /*!< source of the current edge */
+        std::size_t _pos; /*!< index of the current edge in _targets */
+        std::size_t _end; /*!< number of edges */
+};
+
+// --------
+// CsrGraph
+// --------
+
+/**
+ * immutable compressed sparse row companion of Graph
+ * the targets of all the vertices are packed in one array, sorted within each row,
+ * and _offsets[v] .. _offsets[v + 1] delimits the targets of v
+ * adjacency scans are contiguous, which is what the traversal templates spend their time on
+ */
+class CsrGraph
+{
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef std::size_t vertex_descriptor;
+        typedef EdgeDescriptor edge_descriptor;
+
+        typedef boost::counting_iterator<vertex_descriptor> vertex_iterator;
+        typedef CsrEdgeIterator edge_iterator;
+        typedef std::vector<vertex_descriptor>::const_iterator adjacency_iterator;
+
+        typedef std::size_t vertices_size_type;
+        typedef std::size_t edges_size_type;
+
+    public:
+        // --------
+        // add_edge
+        // --------
+
+        /**
+         * possibly add an edge_descriptor between two given vertex_descriptor to the graph
+         * shifts every target after v1's row, O(V + E): meant for small graphs and tests, build from a Graph or an edge list instead
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @return a pair where first of the pair is the edge_descriptor added and second of the pair indicates whether the EdgeDescriptor has been successfully added
+         */
+        friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor v1, vertex_descriptor v2, CsrGraph& g)
+        {
+            edge_descriptor e(v1, v2);
+            if(std::max(v1, v2) >= num_vertices(g))
+            {
+                g._offsets.resize(std::max(v1, v2) + 2, g._offsets.back());
+            }
+            std::vector<vertex_descriptor>::iterator b = g._targets.begin() + g._offsets[v1];
+            std::vector<vertex_descriptor>::iterator e2 = g._targets.begin() + g._offsets[v1 + 1];
+            std::vector<vertex_descriptor>::iterator p = std::lower_bound(b, e2, v2);
+            if(p != e2 && *p == v2)
+            {
+                return std::make_pair(e, false);
+            }
+            g._targets.insert(p, v2);
+            for(vertex_descriptor v = v1 + 1; v < g._offsets.size(); ++v)
+            {
+                ++g._offsets[v];
+            }
+            return std::make_pair(e, true);
+        }
+
+        // ----------
+        // add_vertex
+        // ----------
+
+        /**
+         * add a vertex_descriptor, with no adjacent vertices, to the graph
+         * @param g the graph where vertex_descriptor is added
+         * @return the vertex_descriptor added
+         */
+        friend vertex_descriptor add_vertex (CsrGraph& g)
+        {
+            g._offsets.push_back(g._offsets.back());
+            return num_vertices(g) - 1;
+        }
+
+        // -----------------
+        // adjacent_vertices
+        // -----------------
+
+        /**
+         * adjacent_vertices function
+         * the adjacent vertices are visited in increasing vertex_descriptor order
+         * @param v a vertex_descriptor
+         * @param g the graph where the vertex_descriptor is
+         * @return a pair of adjacency_iterators delimiting v's row
+         */
+        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor v, const CsrGraph& g)
+        {
+            adjacency_iterator b = g._targets.begin() + g._offsets[v];
+            adjacency_iterator e = g._targets.begin() + g._offsets[v + 1];
+            return std::make_pair(b, e);
+        }
+
+        // ----
+        // edge
+        // ----
+
+        /**
+         * edge function
+         * binary search in v1's row, O(log deg(v1))
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @param g the graph where the vertex_descriptor is
+         * @return a pair, where first is the edge_descriptor between the vertices, second is a bool indicates whether the edge_descriptor exists in the graph
+         */
+        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor v1, vertex_descriptor v2, const CsrGraph& g)
+        {
+            edge_descriptor e(v1, v2);
+            if(v1 >= num_vertices(g))
+            {
+                return std::make_pair(e, false);
+            }
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v1, g);
+            return std::make_pair(e, std::binary_search(p.first, p.second, v2));
+        }
+
+        // -----
+        // edges
+        // -----
+
+        /**
+         * edges function
+         * @param g a CsrGraph
+         * @return a pair of edge_iterator visiting the edges by increasing source, then by increasing target
+         */
+        friend std::pair<edge_iterator, edge_iterator> edges (const CsrGraph& g)
+        {
+            edge_iterator b(g._offsets.data(), g._targets.data(), 0, g._targets.size(), num_vertices(g));
+            edge_iterator e(g._offsets.data(), g._targets.data(), g._targets.size(), g._targets.size(), num_vertices(g));
+            return std::make_pair(b, e);
+        }
+
+        // ---------
+        // num_edges
+        // ---------
+
+        /**
+         * num_edges function
+         * @param g a CsrGraph
+         * @return the number of edges in the given graph
+         */
+        friend edges_size_type num_edges (const CsrGraph& g)
+        {
+            return g._targets.size();
+        }
+
+        // ------------
+        // num_vertices
+        // ------------
+
+        /**
+         * num_vertices function
+         * @param g a CsrGraph
+         * @return the number of vertices in the given graph
+         */
+        friend vertices_size_type num_vertices (const CsrGraph& g)
+        {
+            return g._offsets.size() - 1;
+        }
+
+        // ------
+        // source
+        // ------
+
+        /**
+         * source function
+         * @param e an edge_descriptor
+         * @return the source vertex_descriptor of a given edge_descriptor
+         */
+        friend vertex_descriptor source (edge_descriptor e, const CsrGraph&)
+        {
+            return e._source;
+        }
+
+        // ------
+        // target
+        // ------
+
+        /**
+         * target function
+         * @param e an edge_descriptor
+         * @return the target vertex_descriptor of a given edge_descriptor
+         */
+        friend vertex_descriptor target (edge_descriptor e, const CsrGraph&)
+        {
+            return e._target;
+        }
+
+        // ------
+        // vertex
+        // ------
+
+        /**
+         * vertex function
+         * @param nth integral value represents the n term index of the vertex
+         * @return the nth vertex_descriptor of the graph
+         */
+        friend vertex_descriptor vertex (vertices_size_type nth, const CsrGraph&)
+        {
+            return nth;
+        }
+
+        // --------
+        // vertices
+        // --------
+
+        /**
+         * vertices function
+         * @param g a CsrGraph
+         * @return a pair of vertex_iterator in which the first can travel to the second one the eventually visits all the vertices in the given graph
+         */
+        friend std::pair<vertex_iterator, vertex_iterator> vertices (const CsrGraph& g)
+        {
+            return std::make_pair(vertex_iterator(0), vertex_iterator(num_vertices(g)));
+        }
+
+    private:
+        // ----
+        // data
+        // ----
+
+        std::vector<std::size_t> _offsets; /*!< _offsets[v] is the index in _targets of v's first target, one extra entry at the end */
+
+        std::vector<vertex_descriptor> _targets; /*!< the targets of all the rows, back to back */
+
+        // -----
+        // valid
+        // -----
+
+        /**
+         * valid function
+         */
+        bool valid () const
+        {
+            return !_offsets.empty() && _offsets.front() == 0 && _offsets.back() == _targets.size();
+        }
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * default constructor
+         */
+        CsrGraph () : _offsets(1, 0), _targets()
+        {
+            assert(valid());
+        }
+
+        /**
+         * build from a Graph in one O(V + E) pass, the rows of a Graph are already sorted
+         * the vertex_descriptors are kept, a vertex removed from g is an isolated vertex here, compact(g) first to drop it
+         * @param g a Graph, whatever its storage selectors
+         */
+        template <typename OutEdgeS, typename VertexS, typename DirectedS, typename Alloc>
+        explicit CsrGraph (const basic_graph<OutEdgeS, VertexS, DirectedS, Alloc>& g) : _offsets(), _targets()
+        {
+            typedef typename basic_graph<OutEdgeS, VertexS, DirectedS, Alloc>::adjacency_iterator adjacency_iterator;
+
+            _offsets.reserve(vertex_index_bound(g) + 1);
+            _targets.reserve(num_edges(g));
+            _offsets.push_back(0);
+            for(vertex_descriptor v = 0; v < vertex_index_bound(g); ++v)
+            {
+                std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, g);
+                _targets.insert(_targets.end(), p.first, p.second);
+                _offsets.push_back(_targets.size());
+            }
+            assert(valid());
+        }
+
+        /**
+         * build from a range of (source, target) pairs in any order, duplicates are dropped
+         * sort_edge_list lays the rows out, O(V + E) for rows of bounded degree
+         * @param first a forward iterator to std::pair<vertex_descriptor, vertex_descriptor>
+         * @param last end of the range
+         * @param n the minimum number of vertices, the graph has max(n, max(u, v) + 1) vertices
+         */
+        template <typename FI>
+        CsrGraph (FI first, FI last, vertices_size_type n = 0) : _offsets(), _targets()
+        {
+            sort_edge_list(first, last, n, _offsets, _targets);
+            assert(valid());
+        }
+
+        /**
+         * equal operator
+         * @lhs a CsrGraph
+         * @rhs a CsrGraph
+         */
+        friend bool operator == (const CsrGraph& lhs, const CsrGraph& rhs)
+        {
+            return lhs._offsets == rhs._offsets && lhs._targets == rhs._targets;
+        }
+};
+
+// ------------------
+// vertex_index_bound
+// ------------------
+
+/**
+ * for the graphs that never remove a vertex, their vertex_descriptors are 0 to num_vertices(g) - 1
+ * @param g a graph
+ * @return one past the largest vertex_descriptor
+ */
+template <typename G>
+std::size_t vertex_index_bound (const G& g)
+{
+    return num_vertices(g);
+}
+
+/**
+ * the indices below vertex_index_bound(g) that vertices(g) does not visit, the vertices remove_vertex left behind
+ * @param g a graph
+ * @return removed[v] set for each of them, empty if there are none (always, for the graphs that do not remove vertices)
+ */
+template <typename G>
+std::vector<char> removed_vertices (const G& g)
+{
+    std::vector<char> removed;
+    if(num_vertices(g) != vertex_index_bound(g))
+    {
+        removed.assign(vertex_index_bound(g), 1);
+        std::pair<typename G::vertex_iterator, typename G::vertex_iterator> p = vertices(g);
+        for(; p.first != p.second; ++p.first)
+        {
+            removed[*p.first] = 0;
+        }
+    }
+    return removed;
+}
+
+//output iterator that drops everything written to it
+struct discard_iterator
+{
+    typedef std::output_iterator_tag iterator_category;
+    typedef void value_type;
+    typedef void difference_type;
+    typedef void pointer;
+    typedef void reference;
+
+    template <typename T>
+    discard_iterator& operator = (const T&) {return *this;}
+    discard_iterator& operator * () {return *this;}
+    discard_iterator& operator ++ () {return *this;}
+    discard_iterator& operator ++ (int) {return *this;}
+};
+
+// --------
+// ColorMap
+// --------
+
+/**
+ * count trailing zeros of a word that is not 0
+ * @param w the word
+ * @return the index of the lowest bit set
+ */
+inline std::size_t count_trailing_zeros (std::uint64_t w)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(w);
+#else
+    std::size_t n = 0;
+    while((w & 1) == 0)
+    {
+        w >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+/**
+ * the white/grey/black state of a depth-first traversal, two bitsets of one bit per vertex each
+ * a vertex is white while its visited bit is clear, grey once it is set, and black once its finished bit is set too
+ * 2 bits per vertex instead of the 32 of a std::vector<int>, 25 MB instead of 400 MB at 100M vertices
+ */
+class ColorMap
+{
+    public:
+    /**
+     * constructor, every vertex white
+     * @param n the number of vertices
+     */
+    explicit ColorMap (std::size_t n) : _size(n), _visited((n + 63) / 64, 0), _finished((n + 63) / 64, 0)
+    {}
+
+    /**
+     * @return the number of vertices
+     */
+    std::size_t size () const
+    {
+        return _size;
     }
-    return result;
+
+    /**
+     * @param v a vertex
+     * @return whether v has not been reached yet
+     */
+    bool is_white (std::size_t v) const
+    {
+        return !(_visited[v >> 6] & bit(v));
+    }
+
+    /**
+     * @param v a vertex
+     * @return whether v has been reached but not finished, it is on the traversal's stack
+     */
+    bool is_grey (std::size_t v) const
+    {
+        return (_visited[v >> 6] & ~_finished[v >> 6] & bit(v)) != 0;
+    }
+
+    /**
+     * @param v a vertex
+     * @return whether v has been finished
+     */
+    bool is_black (std::size_t v) const
+    {
+        return (_finished[v >> 6] & bit(v)) != 0;
+    }
+
+    /**
+     * @param v a vertex being reached
+     */
+    void set_grey (std::size_t v)
+    {
+        _visited[v >> 6] |= bit(v);
+    }
+
+    /**
+     * @param v a vertex being finished
+     */
+    void set_black (std::size_t v)
+    {
+        _visited[v >> 6] |= bit(v);
+        _finished[v >> 6] |= bit(v);
+    }
+
+    /**
+     * next white vertex, a word of 64 vertices at a time
+     * @param from where the scan starts
+     * @return the first white vertex at or after from, size() if there is none
+     */
+    std::size_t find_white (std::size_t from) const
+    {
+        std::size_t w = from >> 6;
+        if(w >= _visited.size())
+        {
+            return _size;
+        }
+        std::uint64_t white = ~_visited[w] >> (from & 63);
+        if(white != 0)
+        {
+            return std::min(_size, from + count_trailing_zeros(white));
+        }
+        while(white == 0)
+        {
+            if(++w == _visited.size())
+            {
+                return _size;
+            }
+            white = ~_visited[w];
+        }
+        return std::min(_size, (w << 6) + count_trailing_zeros(white)); //the bits past size() are clear and read as white
+    }
+
+    /**
+     * @return the heap held by the two bitsets
+     */
+    std::size_t bytes () const
+    {
+        return (_visited.capacity() + _finished.capacity()) * sizeof(std::uint64_t);
+    }
+
+    private:
+        std::size_t _size; /*!< number of vertices */
+        std::vector<std::uint64_t> _visited; /*!< set for grey and black vertices */
+        std::vector<std::uint64_t> _finished; /*!< set for black vertices */
+
+    /**
+     * @param v a vertex
+     * @return v's bit inside its word
+     */
+    static std::uint64_t bit (std::size_t v)
+    {
+        return std::uint64_t(1) << (v & 63);
+    }
+};
+
+//helper function for DFS, resumes the scan at from (return colors.size() if no white vertex left)
+template <typename G>
+std::size_t get_white_vertex (const G&, const ColorMap& colors, std::size_t from)
+{
+    return colors.find_white(from);
+}
+
+// -------------
+// dfs_postorder
+// -------------
+
+/**
+ * depth-first traversal of the whole graph
+ * three colors, every vertex enters the stack once and every frame resumes its adjacency scan where it left off,
+ * and the roots are found by a cursor that never moves backwards, so the traversal is O(V + E)
+ * the colors live in a ColorMap, 2 bits per vertex, and the cursor skips 64 visited vertices per word
+ * @param g a Graph
+ * @param x an output iterator that receives the vertices as they turn black
+ * @param cycle an output iterator that receives, when a back edge u -> v is found, the path v ... u
+ *        of the stack it closes into a cycle, O(length of the path)
+ * @param stats the scope the vertices visited and the edges examined are counted in, the caller's operation
+ * @return true if a back edge was found (the graph is cyclic), the traversal stops there
+ */
+template <typename G, typename OI, typename CI>
+bool dfs_postorder (const G& g, OI x, CI cycle, GraphStatsScope& stats)
+{
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+    typedef std::pair<vertex_descriptor, std::pair<adjacency_iterator, adjacency_iterator> > frame;
+
+    std::size_t visited = 0; //counted locally, told to stats once
+    std::size_t examined = 0;
+    ColorMap colors(vertex_index_bound(g)); //keep track of the different colors of vertices
+    std::vector<char> removed = removed_vertices(g);
+    for(std::size_t v = 0; v < removed.size(); ++v)
+    {
+        if(removed[v])
+        {
+            colors.set_black(v); //never a root, and no edge leads there
+        }
+    }
+    std::vector<frame> s; //use as a stack, each frame holds a vertex and what is left of its adjacent vertices
+    std::size_t root = 0;
+
+    while((root = get_white_vertex(g, colors, root)) != colors.size())
+    {
+        vertex_descriptor current_vertex = vertex(root, g);
+        colors.set_grey(current_vertex);
+        ++visited;
+        s.push_back(frame(current_vertex, adjacent_vertices(current_vertex, g)));
+        while(!s.empty())
+        {
+            std::pair<adjacency_iterator, adjacency_iterator>& rest = s.back().second;
+            if(rest.first != rest.second)
+            {
+                vertex_descriptor next_vertex = *rest.first;
+                ++rest.first;
+                ++examined;
+                if(!colors.is_black(next_vertex)) //the usual case in a DAG is a neighbour finished already, one bit test
+                {
+                    if(!colors.is_white(next_vertex))
+                    {
+                        std::size_t i = s.size() - 1;
+                        while(s[i].first != next_vertex) //a grey vertex is on the stack
+                        {
+                            --i;
+                        }
+                        for(; i < s.size(); ++i)
+                        {
+                            *cycle = s[i].first;
+                            ++cycle;
+                        }
+                        stats.visit_vertices(visited);
+                        stats.examine_edges(examined);
+                        return true;
+                    }
+                    colors.set_grey(next_vertex);
+                    ++visited;
+                    s.push_back(frame(next_vertex, adjacent_vertices(next_vertex, g)));
+                }
+            }
+            else
+            {
+                current_vertex = s.back().first;
+                colors.set_black(current_vertex);
+                *x = current_vertex;
+                ++x;
+                s.pop_back();
+            }
+        }
+    }
+    stats.visit_vertices(visited);
+    stats.examine_edges(examined);
+    return false;
+}
+
+/**
+ * dfs_postorder counted as an operation of its own
+ * @param g a Graph
+ * @param x an output iterator that receives the vertices as they turn black
+ * @param cycle an output iterator that receives the path of the cycle found, as above
+ * @return true if a back edge was found (the graph is cyclic), the traversal stops there
+ */
+template <typename G, typename OI, typename CI>
+bool dfs_postorder (const G& g, OI x, CI cycle)
+{
+    GraphStatsScope stats(g, op_dfs_postorder);
+    return dfs_postorder(g, x, cycle, stats);
 }
 
-//helper function for DFS (return -1 if no white neighbour)
-template <typename G>
-int get_white_neighbour (const G& g, typename G::vertex_descriptor v, std::vector<int>& colors)
+/**
+ * dfs_postorder without the cycle
+ * @param g a Graph
+ * @param x an output iterator that receives the vertices as they turn black
+ * @return true if a back edge was found (the graph is cyclic), the traversal stops there
+ */
+template <typename G, typename OI>
+bool dfs_postorder (const G& g, OI x)
 {
-    typename G::adjacency_iterator match;
-    match = std::find_if(adjacent_vertices(v, g).first, adjacent_vertices(v, g).second, [&colors](typename G::vertex_descriptor v)
-        {
-            return colors[v] == 0;
-        });
-    if(match == adjacent_vertices(v, g).second)
-    {
-        return -1;
-    }
-    else
-    {
-        return (int)(*match);
-    }
+    return dfs_postorder(g, x, discard_iterator());
 }
 
 // ---------
@@ -400,115 +2439,763 @@ int get_white_neighbour (const G& g, typename G::vertex_descriptor v, std::vecto
 template <typename G>
 bool has_cycle (const G& g) 
 {
-    if(num_vertices(g) == 0)
+    GraphStatsScope stats(g, op_has_cycle);
+    return dfs_postorder(g, discard_iterator(), discard_iterator(), stats);
+}
+
+/**
+ * has_cycle with a witness
+ * @param g a Graph
+ * @param cycle an output iterator that receives the vertices v0 v1 ... vk of a cycle if there is one:
+ *        each has an edge to the next and vk has an edge back to v0 (k = 0 for a self loop)
+ * @return bool indicates whether the graph is cyclic
+ */
+template <typename G, typename OI>
+bool has_cycle (const G& g, OI cycle)
+{
+    GraphStatsScope stats(g, op_has_cycle);
+    return dfs_postorder(g, discard_iterator(), cycle, stats);
+}
+
+// ----------------
+// topological_sort
+// ----------------
+
+/**
+ * a graph type that keeps a topological order overloads this to hand it out, O(V)
+ * @return false, no order is kept
+ */
+template <typename G, typename OI>
+bool kept_order (const G&, OI)
+{
+    return false;
+}
+
+/**
+ * depth-first traversal
+ * three colors, cycle detection and ordering in the same O(V + E) pass
+ * a graph that keeps a topological order (a basic_graph grown with add_edge_acyclic) hands it out instead, in O(V)
+ * performs a topological sort on a graph and stream the outoput to an output iterator
+ * nothing is written to x if the graph is cyclic
+ * @param g a Graph
+ * @param x an output iteration
+ * @throws Boost's not_a_dag exception if has_cycle()
+ */
+template <typename G, typename OI>
+void topological_sort (const G& g, OI x) 
+{
+    GraphStatsScope stats(g, op_topological_sort);
+    if(kept_order(g, x))
+    {
+        stats.visit_vertices(num_vertices(g));
+        return;
+    }
+    std::vector<typename G::vertex_descriptor> result;
+    result.reserve(num_vertices(g));
+    if(dfs_postorder(g, std::back_inserter(result), discard_iterator(), stats))
+    {
+        throw boost::not_a_dag();
+    }
+    std::copy(result.begin(), result.end(), x);
+}
+
+// -------------
+// ThreadBarrier
+// -------------
+
+/**
+ * reusable barrier for a fixed number of threads
+ * the last thread to arrive at wait() releases the others and starts a new generation
+ */
+class ThreadBarrier
+{
+    public:
+    /**
+     * constructor
+     * @param n the number of threads that have to call wait() before any of them returns
+     */
+    explicit ThreadBarrier (std::size_t n) : _mutex(), _released(), _threads(n), _waiting(0), _generation(0)
+    {}
+
+    /**
+     * block until all the threads have called wait()
+     */
+    void wait ()
     {
-        return false;
+        std::unique_lock<std::mutex> lock(_mutex);
+        std::size_t generation = _generation;
+        if(++_waiting == _threads)
+        {
+            _waiting = 0;
+            ++_generation;
+            _released.notify_all();
+        }
+        else
+        {
+            while(generation == _generation)
+            {
+                _released.wait(lock);
+            }
+        }
     }
 
-    std::vector<int> colors(num_vertices(g), 0); //keep track of the different colors of vertices (0 while, 1 grey, 2 black)
-    std::deque<typename G::vertex_descriptor> s; //use as a stack
-    typename G::vertex_descriptor current_vertex;
-    int current_vertex_index;
-    int next_vertex_index;
-    bool stack_empty;
+    private:
+        std::mutex _mutex;
+        std::condition_variable _released;
+        std::size_t _threads; /*!< number of threads taking part */
+        std::size_t _waiting; /*!< number of threads blocked in the current generation */
+        std::size_t _generation; /*!< bumped every time the barrier opens */
+};
+
+// ---------------------------
+// parallel_topological_levels
+// ---------------------------
+
+/**
+ * Kahn's algorithm, one frontier at a time, spread over a pool of threads
+ * the in-degrees are atomic counters, each thread claims chunks of the current frontier and pushes
+ * the vertices whose counter reaches zero into its own buffer, and the buffers are merged between levels
+ * the levels are written in the same direction as topological_sort: a vertex only depends on (points to)
+ * vertices of earlier levels, so concatenating them gives a valid topological_sort output
+ * each level is a std::vector of vertex_descriptors sorted in increasing order
+ * nothing is written to x if the graph is cyclic
+ * @param g a Graph
+ * @param x an output iterator that receives the levels
+ * @param threads the number of threads to use, the calling thread included
+ * @throws Boost's not_a_dag exception if has_cycle()
+ */
+template <typename G, typename OI>
+void parallel_topological_levels (const G& g, OI x, std::size_t threads = std::thread::hardware_concurrency())
+{
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    const std::size_t n = vertex_index_bound(g);
+    const std::size_t chunk = 256; //number of frontier vertices claimed at a time
+    const std::vector<char> removed = removed_vertices(g);
+    threads = std::max<std::size_t>(threads, 1);
+
+    std::unique_ptr<std::atomic<std::size_t>[]> in_degree(new std::atomic<std::size_t>[n]);
+    std::vector< std::vector<vertex_descriptor> > levels;
+    std::vector<vertex_descriptor> frontier;
+    std::vector< std::vector<vertex_descriptor> > buffers(threads); //per-thread part of the next frontier
+    std::atomic<std::size_t> cursor(0); //next unclaimed index in frontier
+    std::size_t visited = 0;
+    std::vector<std::size_t> examined(threads, 0); //per-thread edge counts, for the stats
+    ThreadBarrier barrier(threads);
+    GraphStatsScope stats(g, op_parallel_topological_levels);
+
+    //the vertices [b, e) handled by thread t in the per-vertex phases
+    auto slice = [n, threads] (std::size_t t) {return std::make_pair(n * t / threads, n * (t + 1) / threads);};
+
+    //thread 0 only, between two barriers: turn the buffers into the next frontier
+    auto merge = [&] ()
+    {
+        frontier.clear();
+        for(std::size_t t = 0; t < threads; ++t)
+        {
+            frontier.insert(frontier.end(), buffers[t].begin(), buffers[t].end());
+            buffers[t].clear();
+        }
+        std::sort(frontier.begin(), frontier.end());
+        if(!frontier.empty())
+        {
+            levels.push_back(frontier);
+        }
+        visited += frontier.size();
+        cursor.store(0, std::memory_order_relaxed);
+    };
 
-    while(get_white_vertex(g, colors) != -1)
+    auto work = [&] (std::size_t t)
     {
-        current_vertex_index = get_white_vertex(g, colors);
-        current_vertex = vertex(current_vertex_index, g);
-        colors[current_vertex_index] = 1;
-        do
+        std::size_t edges = 0;
+        std::pair<std::size_t, std::size_t> s = slice(t);
+        for(std::size_t i = s.first; i < s.second; ++i)
+        {
+            in_degree[i].store(0, std::memory_order_relaxed);
+        }
+        barrier.wait();
+        for(std::size_t i = s.first; i < s.second; ++i)
+        {
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(i, g);
+            for(; p.first != p.second; ++p.first)
+            {
+                in_degree[*p.first].fetch_add(1, std::memory_order_relaxed);
+                ++edges;
+            }
+        }
+        barrier.wait();
+        for(std::size_t i = s.first; i < s.second; ++i)
+        {
+            if(in_degree[i].load(std::memory_order_relaxed) == 0 && (removed.empty() || !removed[i]))
+            {
+                buffers[t].push_back(i);
+            }
+        }
+        barrier.wait();
+        if(t == 0)
+        {
+            merge();
+        }
+        barrier.wait();
+        while(!frontier.empty())
         {
-            if(has_grey_neighbour(g, current_vertex, colors))
+            std::size_t b;
+            while((b = cursor.fetch_add(chunk, std::memory_order_relaxed)) < frontier.size())
+            {
+                std::size_t e = std::min(b + chunk, frontier.size());
+                for(std::size_t i = b; i < e; ++i)
+                {
+                    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(frontier[i], g);
+                    for(; p.first != p.second; ++p.first)
+                    {
+                        ++edges;
+                        if(in_degree[*p.first].fetch_sub(1, std::memory_order_relaxed) == 1)
+                        {
+                            buffers[t].push_back(*p.first);
+                        }
+                    }
+                }
+            }
+            barrier.wait();
+            if(t == 0)
             {
-                return true;
+                merge();
             }
-            if((next_vertex_index = get_white_neighbour(g, current_vertex, colors)) != -1)
+            barrier.wait();
+        }
+        examined[t] = edges;
+    };
+
+    std::vector<std::thread> pool;
+    for(std::size_t t = 1; t < threads; ++t)
+    {
+        pool.push_back(std::thread(work, t));
+    }
+    work(0);
+    for(std::size_t t = 0; t < pool.size(); ++t)
+    {
+        pool[t].join();
+    }
+    stats.visit_vertices(visited);
+    stats.examine_edges(std::accumulate(examined.begin(), examined.end(), std::size_t(0)));
+
+    if(visited != num_vertices(g))
+    {
+        throw boost::not_a_dag();
+    }
+    std::copy(levels.rbegin(), levels.rend(), x);
+}
+
+// ----------------------------
+// strongly_connected_components
+// ----------------------------
+
+/**
+ * Tarjan's algorithm, iterative: the frames resume their adjacency scan like dfs_postorder does, so
+ * there is no recursion to overflow on long paths, O(V + E)
+ * the components are numbered in the order they are completed, which is a reverse topological order of
+ * the condensation (sinks first, like topological_sort): an edge between two components goes from a
+ * higher number to a lower one
+ * @param g a Graph
+ * @param component a random access iterator, component[v] receives the number of v's component, for the vertices of vertices(g)
+ * @return the number of components, the graph is acyclic when it equals num_vertices(g) and there is no self loop
+ */
+template <typename G, typename RI>
+std::size_t strongly_connected_components (const G& g, RI component)
+{
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+    typedef std::pair<vertex_descriptor, std::pair<adjacency_iterator, adjacency_iterator> > frame;
+
+    typedef typename G::vertex_iterator vertex_iterator;
+
+    const std::size_t n = vertex_index_bound(g);
+    const std::size_t unvisited = std::size_t(-1);
+    std::vector<std::size_t> index(n, unvisited); //order of discovery
+    std::vector<std::size_t> low(n); //smallest index reachable through the subtree and one back edge
+    std::vector<bool> on_stack(n, false);
+    std::vector<vertex_descriptor> pending; //visited vertices whose component is not complete yet
+    std::vector<frame> s;
+    std::size_t discovered = 0;
+    std::size_t components = 0;
+    std::size_t examined = 0;
+    GraphStatsScope stats(g, op_strongly_connected_components);
+
+    std::pair<vertex_iterator, vertex_iterator> roots = vertices(g);
+    for(; roots.first != roots.second; ++roots.first)
+    {
+        if(index[*roots.first] != unvisited)
+        {
+            continue;
+        }
+        vertex_descriptor v = *roots.first;
+        index[v] = low[v] = discovered++;
+        pending.push_back(v);
+        on_stack[v] = true;
+        s.push_back(frame(v, adjacent_vertices(v, g)));
+        while(!s.empty())
+        {
+            v = s.back().first;
+            std::pair<adjacency_iterator, adjacency_iterator>& rest = s.back().second;
+            if(rest.first != rest.second)
             {
-                colors[next_vertex_index] = 1;
-                s.push_back(current_vertex);
-                current_vertex = vertex(next_vertex_index, g);
-                current_vertex_index = (int)current_vertex;
+                vertex_descriptor w = *rest.first;
+                ++rest.first;
+                ++examined;
+                if(index[w] == unvisited)
+                {
+                    index[w] = low[w] = discovered++;
+                    pending.push_back(w);
+                    on_stack[w] = true;
+                    s.push_back(frame(w, adjacent_vertices(w, g)));
+                }
+                else if(on_stack[w])
+                {
+                    low[v] = std::min(low[v], index[w]);
+                }
             }
             else
             {
-                colors[current_vertex_index] = 2;
-                if(!(stack_empty = s.empty()))
+                s.pop_back();
+                if(low[v] == index[v])
+                {
+                    vertex_descriptor w;
+                    do
+                    {
+                        w = pending.back();
+                        pending.pop_back();
+                        on_stack[w] = false;
+                        component[w] = components;
+                    }
+                    while(w != v);
+                    ++components;
+                }
+                if(!s.empty())
                 {
-                    current_vertex = s.back();
-                    current_vertex_index = (int)current_vertex;
-                    s.pop_back();
+                    vertex_descriptor parent = s.back().first;
+                    low[parent] = std::min(low[parent], low[v]);
                 }
             }
-        }while(!stack_empty);
+        }
     }
-    return false;
+    stats.visit_vertices(discovered);
+    stats.examine_edges(examined);
+    return components;
 }
 
-// ----------------
-// topological_sort
-// ----------------
+// --------------------------------------
+// parallel_strongly_connected_components
+// --------------------------------------
 
 /**
- * depth-first traversal
- * two colors
- * performs a topological sort on a graph and stream the outoput to an output iterator
+ * trimming and coloring (Orzan's forward-backward coloring), spread over a pool of threads
+ *   1. the transposed graph is built with atomic counters
+ *   2. trimming: the vertices no remaining vertex points to, then those pointing to no remaining vertex,
+ *      are components on their own, each thread peels from its own worklist, a DAG is trimmed entirely here
+ *   3. coloring, repeated on what is left: every vertex takes the largest vertex_descriptor that reaches it,
+ *      by a worklist propagation with an atomic max, each vertex whose color equals itself is a root, and
+ *      the vertices of its color that reach it backwards are its component, the roots are claimed by the threads
+ * the components are the same as strongly_connected_components but not numbered in any particular order
+ * the coloring passes are many on graphs whose cycles are long and do not connect, it is meant for large
+ * graphs with a few big components and many small ones
  * @param g a Graph
- * @param x an output iteration
- * @throws Boost's not_a_dag exception if has_cycle()
+ * @param component a random access iterator, component[v] receives the number of v's component, for the vertices of vertices(g)
+ * @param threads the number of threads to use, the calling thread included
+ * @return the number of components
  */
-template <typename G, typename OI>
-void topological_sort (const G& g, OI x) 
+template <typename G, typename RI>
+std::size_t parallel_strongly_connected_components (const G& g, RI component, std::size_t threads = std::thread::hardware_concurrency())
 {
-    if(has_cycle(g))
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    const std::size_t n = vertex_index_bound(g);
+    const std::size_t none = std::size_t(-1);
+    const std::size_t dead = none - 1; //the comp of a removed vertex, it takes no part
+    const std::vector<char> removed = removed_vertices(g);
+    threads = std::max<std::size_t>(threads, 1);
+
+    std::unique_ptr<std::atomic<std::size_t>[]> comp(new std::atomic<std::size_t>[n]); //none while the vertex remains
+    std::unique_ptr<std::atomic<std::size_t>[]> counter(new std::atomic<std::size_t>[n]); //degrees, then colors
+    std::vector<std::size_t> in_offsets(n + 1, 0); //the transposed graph, as compressed sparse rows
+    std::vector<vertex_descriptor> in_sources;
+    std::vector<vertex_descriptor> roots;
+    std::vector< std::vector<vertex_descriptor> > buffers(threads); //per-thread roots
+    std::atomic<std::size_t> next_component(0);
+    std::atomic<std::size_t> cursor(0); //next unclaimed root
+    ThreadBarrier barrier(threads);
+    GraphStatsScope stats(g, op_parallel_strongly_connected_components); //totals only, the vertices and the edges transposed
+
+    auto slice = [n, threads] (std::size_t t) {return std::make_pair(n * t / threads, n * (t + 1) / threads);};
+    auto remains = [&] (std::size_t v) {return comp[v].load(std::memory_order_relaxed) == none;};
+
+    //a vertex whose counter reached 0 is trimmed by whoever turns the 0 into none, its own slice or a neighbour's trim
+    auto claim = [&] (vertex_descriptor v, std::vector<vertex_descriptor>& work)
     {
-        throw boost::not_a_dag();
+        std::size_t expected = 0;
+        if(counter[v].compare_exchange_strong(expected, none, std::memory_order_relaxed))
+        {
+            work.push_back(v);
+        }
+    };
+
+    //peel v and whatever its removal frees, forward uses the out-rows and backward the in-rows
+    auto trim = [&] (vertex_descriptor v, bool forward, std::vector<vertex_descriptor>& work)
+    {
+        claim(v, work);
+        while(!work.empty())
+        {
+            v = work.back();
+            work.pop_back();
+            comp[v].store(next_component.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+            if(forward)
+            {
+                std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, g);
+                for(; p.first != p.second; ++p.first)
+                {
+                    if(counter[*p.first].fetch_sub(1, std::memory_order_relaxed) == 1)
+                    {
+                        claim(*p.first, work);
+                    }
+                }
+            }
+            else
+            {
+                for(std::size_t i = in_offsets[v]; i != in_offsets[v + 1]; ++i)
+                {
+                    vertex_descriptor u = in_sources[i];
+                    if(remains(u) && counter[u].fetch_sub(1, std::memory_order_relaxed) == 1)
+                    {
+                        claim(u, work);
+                    }
+                }
+            }
+        }
+    };
+
+    auto work = [&] (std::size_t t)
+    {
+        std::pair<std::size_t, std::size_t> s = slice(t);
+        std::vector<vertex_descriptor> stack;
+
+        //1. transpose
+        for(std::size_t i = s.first; i < s.second; ++i)
+        {
+            comp[i].store(removed.empty() || !removed[i] ? none : dead, std::memory_order_relaxed);
+            counter[i].store(0, std::memory_order_relaxed);
+        }
+        barrier.wait();
+        for(std::size_t i = s.first; i < s.second; ++i)
+        {
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(i, g);
+            for(; p.first != p.second; ++p.first)
+            {
+                counter[*p.first].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        barrier.wait();
+        if(t == 0)
+        {
+            for(std::size_t v = 0; v < n; ++v)
+            {
+                in_offsets[v + 1] = in_offsets[v] + counter[v].load(std::memory_order_relaxed);
+                counter[v].store(in_offsets[v], std::memory_order_relaxed); //now the fill cursor of v's in-row
+            }
+            in_sources.resize(in_offsets[n]);
+        }
+        barrier.wait();
+        for(std::size_t i = s.first; i < s.second; ++i)
+        {
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(i, g);
+            for(; p.first != p.second; ++p.first)
+            {
+                in_sources[counter[*p.first].fetch_add(1, std::memory_order_relaxed)] = i;
+            }
+        }
+        barrier.wait();
+
+        //2. trimming, forward then backward
+        for(std::size_t i = s.first; i < s.second; ++i)
+        {
+            counter[i].store(in_offsets[i + 1] - in_offsets[i], std::memory_order_relaxed);
+        }
+        barrier.wait();
+        for(std::size_t i = s.first; i < s.second; ++i)
+        {
+            if(remains(i) && counter[i].load(std::memory_order_relaxed) == 0)
+            {
+                trim(i, true, stack);
+            }
+        }
+        barrier.wait();
+        for(std::size_t i = s.first; i < s.second; ++i)
+        {
+            std::size_t live = 0;
+            if(remains(i))
+            {
+                std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(i, g);
+                for(; p.first != p.second; ++p.first)
+                {
+                    live += remains(*p.first);
+                }
+            }
+            counter[i].store(live, std::memory_order_relaxed);
+        }
+        barrier.wait();
+        for(std::size_t i = s.first; i < s.second; ++i)
+        {
+            if(remains(i) && counter[i].load(std::memory_order_relaxed) == 0)
+            {
+                trim(i, false, stack);
+            }
+        }
+        barrier.wait();
+
+        //3. coloring, until every vertex has its component
+        while(true)
+        {
+            for(std::size_t i = s.first; i < s.second; ++i)
+            {
+                counter[i].store(i, std::memory_order_relaxed);
+            }
+            barrier.wait();
+            for(std::size_t i = s.second; i-- > s.first; ) //the largest colors first, fewer vertices are raised twice
+            {
+                if(!remains(i))
+                {
+                    continue;
+                }
+                stack.push_back(i);
+                while(!stack.empty())
+                {
+                    vertex_descriptor v = stack.back();
+                    stack.pop_back();
+                    std::size_t color = counter[v].load(std::memory_order_relaxed);
+                    std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, g);
+                    for(; p.first != p.second; ++p.first)
+                    {
+                        vertex_descriptor w = *p.first;
+                        if(!remains(w))
+                        {
+                            continue;
+                        }
+                        std::size_t old = counter[w].load(std::memory_order_relaxed);
+                        while(old < color && !counter[w].compare_exchange_weak(old, color, std::memory_order_relaxed))
+                        {}
+                        if(old < color)
+                        {
+                            stack.push_back(w);
+                        }
+                    }
+                }
+            }
+            barrier.wait();
+            for(std::size_t i = s.first; i < s.second; ++i)
+            {
+                if(remains(i) && counter[i].load(std::memory_order_relaxed) == i)
+                {
+                    buffers[t].push_back(i);
+                }
+            }
+            barrier.wait();
+            if(t == 0)
+            {
+                roots.clear();
+                for(std::size_t b = 0; b < threads; ++b)
+                {
+                    roots.insert(roots.end(), buffers[b].begin(), buffers[b].end());
+                    buffers[b].clear();
+                }
+                cursor.store(0, std::memory_order_relaxed);
+            }
+            barrier.wait();
+            if(roots.empty())
+            {
+                break;
+            }
+            std::size_t r;
+            while((r = cursor.fetch_add(1, std::memory_order_relaxed)) < roots.size())
+            {
+                vertex_descriptor root = roots[r];
+                std::size_t id = next_component.fetch_add(1, std::memory_order_relaxed);
+                comp[root].store(id, std::memory_order_relaxed);
+                stack.push_back(root);
+                while(!stack.empty())
+                {
+                    vertex_descriptor v = stack.back();
+                    stack.pop_back();
+                    for(std::size_t i = in_offsets[v]; i != in_offsets[v + 1]; ++i)
+                    {
+                        vertex_descriptor u = in_sources[i];
+                        if(remains(u) && counter[u].load(std::memory_order_relaxed) == root)
+                        {
+                            comp[u].store(id, std::memory_order_relaxed);
+                            stack.push_back(u);
+                        }
+                    }
+                }
+            }
+            barrier.wait();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(std::size_t t = 1; t < threads; ++t)
+    {
+        pool.push_back(std::thread(work, t));
     }
-    else
+    work(0);
+    for(std::size_t t = 0; t < pool.size(); ++t)
+    {
+        pool[t].join();
+    }
+
+    for(std::size_t v = 0; v < n; ++v)
     {
-        std::vector<int> colors(num_vertices(g), 0); //keep track of the different colors of vertices (0 while, 1 grey, 2 black)
-        std::deque<typename G::vertex_descriptor> s; //use as a stack
-        int current_vertex_index;
-        int next_vertex_index;
-        bool stack_empty;
-        typename G::vertex_descriptor current_vertex;
+        if(removed.empty() || !removed[v])
+        {
+            component[v] = comp[v].load(std::memory_order_relaxed);
+        }
+    }
+    stats.visit_vertices(num_vertices(g));
+    stats.examine_edges(in_sources.size());
+    return next_component.load();
+}
+
+// -------
+// reorder
+// -------
+
+/**
+ * the vertex orders reorder can relabel a graph with, each meant to bring the vertices a traversal
+ * visits one after the other close together in the vertex-indexed arrays (rows, colors, positions)
+ */
+enum ReorderStrategy
+{
+    reorder_bfs, /*!< breadth-first, the edges taken both ways, each tree rooted at the smallest vertex not reached yet */
+    reorder_rcm, /*!< reverse Cuthill-McKee: breadth-first from a vertex of least degree, the neighbours by increasing degree, the whole order reversed */
+    reorder_degree /*!< by decreasing number of neighbours, in or out, the hubs packed at the front, ties in vertex_descriptor order */
+};
 
-        std::deque<typename G::vertex_descriptor> result;
+/**
+ * what reorder returns, the relabeled graph and the two ways to translate between the labels
+ */
+template <typename G>
+struct Reordering
+{
+    G graph;
+    std::vector<typename G::vertex_descriptor> permutation; /*!< permutation[v] is v's vertex_descriptor in graph, std::size_t(-1) if v was removed */
+    std::vector<typename G::vertex_descriptor> inverse; /*!< inverse[w] is the vertex_descriptor in the original graph of w */
+};
 
-   while((current_vertex_index = get_white_vertex(g, colors)) != -1)
+/**
+ * a copy of a graph with its vertices renumbered, O(V + E) for bfs and degree, plus the sorting of each
+ * vertex's new neighbours by degree for rcm
+ * the orderings treat the graph as undirected: an edge pulls its two ends together whichever way it points
+ * the removed vertices are left out, so the copy is compact, and the copy is built like G(first, last, n) from the relabeled edges
+ * a result on the copy is translated back with inverse, a topological order say, or the components indexed by permutation
+ * @param g a graph
+ * @param strategy the order of the new vertex_descriptors
+ * @return the copy, permutation and inverse
+ */
+template <typename G>
+Reordering<G> reorder (const G& g, ReorderStrategy strategy)
+{
+    typedef typename G::vertex_descriptor vertex_descriptor;
+    typedef typename G::vertex_iterator vertex_iterator;
+    typedef typename G::adjacency_iterator adjacency_iterator;
+    typedef std::vector< std::pair<vertex_descriptor, vertex_descriptor> > edge_list;
+
+    GraphStatsScope stats(g, op_reorder);
+    const std::size_t n = vertex_index_bound(g);
+    const vertex_descriptor none = vertex_descriptor(-1);
+
+    //the live vertices, in increasing order, and every edge both ways as compressed sparse rows
+    std::vector<vertex_descriptor> live;
+    edge_list both;
+    std::pair<vertex_iterator, vertex_iterator> p = vertices(g);
+    for(; p.first != p.second; ++p.first)
+    {
+        live.push_back(*p.first);
+        std::pair<adjacency_iterator, adjacency_iterator> a = adjacent_vertices(*p.first, g);
+        for(; a.first != a.second; ++a.first)
+        {
+            both.push_back(std::make_pair(*p.first, *a.first));
+            both.push_back(std::make_pair(*a.first, *p.first));
+        }
+    }
+    std::vector<std::size_t> offsets;
+    std::vector<vertex_descriptor> neighbours;
+    sort_edge_list(both.begin(), both.end(), n, offsets, neighbours);
+    stats.visit_vertices(live.size());
+    stats.examine_edges(both.size());
+    edge_list().swap(both);
+    auto by_degree = [&offsets] (vertex_descriptor u, vertex_descriptor v) {return offsets[u + 1] - offsets[u] < offsets[v + 1] - offsets[v];};
+
+    std::vector<vertex_descriptor> order; //the old vertex_descriptors in their new order
+    order.reserve(live.size());
+    if(strategy == reorder_degree)
+    {
+        order = live;
+        std::stable_sort(order.begin(), order.end(), [&by_degree] (vertex_descriptor u, vertex_descriptor v) {return by_degree(v, u);});
+    }
+    else
     {
-        current_vertex = vertex(current_vertex_index, g);
-        colors[current_vertex_index] = 1;
-        do
+        std::vector<vertex_descriptor> roots = live;
+        if(strategy == reorder_rcm)
         {
-            if((next_vertex_index = get_white_neighbour(g, current_vertex, colors)) != -1)
+            std::stable_sort(roots.begin(), roots.end(), by_degree); //the least degree is the usual cheap stand-in for a peripheral vertex
+        }
+        std::vector<char> reached(n, 0);
+        for(std::size_t r = 0; r < roots.size(); ++r)
+        {
+            if(reached[roots[r]])
             {
-                colors[next_vertex_index] = 1;
-                s.push_back(current_vertex);
-                current_vertex = vertex(next_vertex_index, g);
-                current_vertex_index = (int)current_vertex;
+                continue;
             }
-            else
+            reached[roots[r]] = 1;
+            order.push_back(roots[r]);
+            for(std::size_t head = order.size() - 1; head != order.size(); ++head) //order is the queue too
             {
-                colors[current_vertex_index] = 2;
-                result.push_back(current_vertex_index);
-                if(!(stack_empty = s.empty()))
+                vertex_descriptor v = order[head];
+                std::size_t first = order.size();
+                for(std::size_t i = offsets[v]; i != offsets[v + 1]; ++i)
+                {
+                    if(!reached[neighbours[i]])
+                    {
+                        reached[neighbours[i]] = 1;
+                        order.push_back(neighbours[i]);
+                    }
+                }
+                if(strategy == reorder_rcm)
                 {
-                    current_vertex = s.back();
-                    current_vertex_index = (int)current_vertex;
-                    s.pop_back();
+                    std::stable_sort(order.begin() + first, order.end(), by_degree);
                 }
             }
-        }while(!stack_empty);
-    }  
+        }
+        if(strategy == reorder_rcm)
+        {
+            std::reverse(order.begin(), order.end());
+        }
+    }
 
-        while(!result.empty())
+    std::vector<vertex_descriptor> permutation(n, none);
+    for(std::size_t i = 0; i < order.size(); ++i)
+    {
+        permutation[order[i]] = i;
+    }
+    edge_list relabeled;
+    for(std::size_t i = 0; i < live.size(); ++i)
+    {
+        std::pair<adjacency_iterator, adjacency_iterator> a = adjacent_vertices(live[i], g);
+        for(; a.first != a.second; ++a.first)
         {
-            *x = result.front();
-            result.pop_front();
-            ++x;
+            relabeled.push_back(std::make_pair(permutation[live[i]], permutation[*a.first]));
         }
     }
+    Reordering<G> r = {G(relabeled.begin(), relabeled.end(), order.size()), std::move(permutation), std::move(order)};
+    return r;
 }
 
 #endif // Graph_h
\ No newline at end of file
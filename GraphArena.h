@@ -0,0 +1,203 @@
+// ---------------------------
+// projects/graph/GraphArena.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ---------------------------
+
+#ifndef GraphArena_h
+#define GraphArena_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // max
+#include <cstddef>   // size_t, max_align_t
+#include <new>       // operator delete, operator new
+
+/*
+A basic_graph whose allocator is an ArenaAllocator takes every row, vertex list and
+row list from one MonotonicArena:
+
+    MonotonicArena arena;
+    basic_graph<vectorS, vectorS, boost::directedS, ArenaAllocator<std::size_t> > g((ArenaAllocator<std::size_t>(arena)));
+
+Allocations are a pointer bump, deallocations do nothing, and all the memory goes back
+to the system in one go when the arena is released or destroyed. The memory a container
+gives up while growing is only reclaimed then, so an arena suits graphs that are built,
+queried and thrown away, not graphs that churn for a long time.
+The arena must outlive the graphs that use it. It is not thread-safe.
+*/
+
+// --------------
+// MonotonicArena
+// --------------
+
+class MonotonicArena
+{
+    public:
+    /**
+     * constructor
+     * @param chunk_size size of the first chunk, each following chunk doubles up to max_chunk_size
+     */
+    explicit MonotonicArena (std::size_t chunk_size = 1 << 16) : _chunks(0), _current(0), _end(0), _chunk_size(chunk_size), _allocated(0)
+    {}
+
+    /**
+     * destructor, releases all the chunks
+     */
+    ~MonotonicArena ()
+    {
+        release();
+    }
+
+    /**
+     * hand out bytes from the current chunk, starting a new chunk when it is full
+     * @param bytes number of bytes
+     * @param alignment a power of two, at most alignof(std::max_align_t)
+     * @return the memory
+     */
+    void* allocate (std::size_t bytes, std::size_t alignment)
+    {
+        std::size_t misalignment = reinterpret_cast<std::size_t>(_current) & (alignment - 1);
+        char* p = _current + (misalignment == 0 ? 0 : alignment - misalignment);
+        if(_current == 0 || p + bytes > _end)
+        {
+            new_chunk(bytes);
+            p = _current;
+        }
+        _current = p + bytes;
+        _allocated += bytes;
+        return p;
+    }
+
+    /**
+     * give every chunk back to the system, everything allocated from the arena becomes invalid
+     */
+    void release ()
+    {
+        while(_chunks != 0)
+        {
+            Chunk* next = _chunks->next;
+            ::operator delete(_chunks);
+            _chunks = next;
+        }
+        _current = 0;
+        _end = 0;
+        _allocated = 0;
+    }
+
+    /**
+     * @return the bytes handed out since the last release
+     */
+    std::size_t bytes_allocated () const
+    {
+        return _allocated;
+    }
+
+    static const std::size_t max_chunk_size = 64 << 20;
+
+    private:
+        struct Chunk
+        {
+            Chunk* next;
+            std::max_align_t align; /*!< the bytes handed out start here */
+        };
+
+        Chunk* _chunks; /*!< newest chunk first */
+        char* _current; /*!< next free byte in the newest chunk */
+        char* _end; /*!< end of the newest chunk */
+        std::size_t _chunk_size; /*!< size of the next chunk */
+        std::size_t _allocated; /*!< bytes handed out */
+
+        MonotonicArena (const MonotonicArena&);
+        MonotonicArena& operator = (const MonotonicArena&);
+
+    /**
+     * start a chunk big enough for bytes
+     * @param bytes the request that did not fit
+     */
+    void new_chunk (std::size_t bytes)
+    {
+        std::size_t size = std::max(_chunk_size, bytes);
+        Chunk* c = static_cast<Chunk*>(::operator new(offsetof(Chunk, align) + size));
+        c->next = _chunks;
+        _chunks = c;
+        _current = reinterpret_cast<char*>(&c->align);
+        _end = _current + size;
+        if(_chunk_size < max_chunk_size)
+        {
+            _chunk_size *= 2;
+        }
+    }
+};
+
+// --------------
+// ArenaAllocator
+// --------------
+
+template <typename T>
+class ArenaAllocator
+{
+    public:
+        typedef T value_type;
+
+    /**
+     * constructor
+     * @param arena where the memory comes from
+     */
+    explicit ArenaAllocator (MonotonicArena& arena) : _arena(&arena)
+    {}
+
+    /**
+     * converting constructor, for the containers that rebind
+     * @param a an allocator on the same arena
+     */
+    template <typename U>
+    ArenaAllocator (const ArenaAllocator<U>& a) : _arena(a.arena())
+    {}
+
+    /**
+     * @param n number of objects
+     * @return room for n objects
+     */
+    T* allocate (std::size_t n)
+    {
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    /**
+     * nothing, the memory goes back with the arena
+     */
+    void deallocate (T*, std::size_t)
+    {}
+
+    /**
+     * @return the arena
+     */
+    MonotonicArena* arena () const
+    {
+        return _arena;
+    }
+
+    /**
+     * == operator for ArenaAllocator, memory from one can be given back to the other
+     * @param lhs a ArenaAllocator
+     * @param rhs a ArenaAllocator
+     * @return a bool that indicates whether both use the same arena
+     */
+    friend bool operator == (const ArenaAllocator& lhs, const ArenaAllocator& rhs)
+    {
+        return lhs.arena() == rhs.arena();
+    }
+
+    friend bool operator != (const ArenaAllocator& lhs, const ArenaAllocator& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    private:
+        MonotonicArena* _arena;
+};
+
+#endif // GraphArena_h
@@ -0,0 +1,563 @@
+// --------------------------------
+// projects/graph/GraphCompressed.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// --------------------------------
+
+#ifndef GraphCompressed_h
+#define GraphCompressed_h
+
+// --------
+// includes
+// --------
+
+#include <cassert>  // assert
+#include <cstddef>  // ptrdiff_t, size_t
+#include <cstdint>  // uint8_t
+#include <iterator> // forward_iterator_tag
+#include <utility>  // make_pair, pair
+#include <vector>   // vector
+
+#include "boost/iterator/counting_iterator.hpp" // counting_iterator
+
+#include "Graph.h"
+
+/*
+A CompressedGraph is a read-only CSR graph whose rows are byte streams instead of arrays
+of std::size_t. A sorted row t0 < t1 < ... of vertex v is stored as the varints of
+    zigzag(t0 - v), t1 - t0 - 1, t2 - t1 - 1, ...
+where a varint is the LEB128 encoding, 7 bits per byte and the high bit set on every byte
+but the last. Neighbours close to their source, or to each other, take one byte each.
+The rows are decoded on the fly by the adjacency_iterator, so has_cycle, topological_sort
+and everything else written against the free functions work unchanged.
+*/
+
+// -------
+// varints
+// -------
+
+/**
+ * append the LEB128 encoding of x
+ * @param x the value
+ * @param out the bytes
+ */
+inline void encode_varint (std::size_t x, std::vector<std::uint8_t>& out)
+{
+    while(x >= 0x80)
+    {
+        out.push_back(static_cast<std::uint8_t>(x | 0x80));
+        x >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(x));
+}
+
+/**
+ * read one LEB128 encoding
+ * @param p the first byte, left just past the last one
+ * @return the value
+ */
+inline std::size_t decode_varint (const std::uint8_t*& p)
+{
+    std::size_t x = *p & 0x7f;
+    unsigned shift = 7;
+    while(*p++ & 0x80)
+    {
+        x |= static_cast<std::size_t>(*p & 0x7f) << shift;
+        shift += 7;
+    }
+    return x;
+}
+
+// ---------------------------
+// CompressedAdjacencyIterator
+// ---------------------------
+
+class CompressedAdjacencyIterator
+{
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::size_t value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const std::size_t* pointer;
+        typedef std::size_t reference;
+
+    /**
+     * default constructor
+     */
+    CompressedAdjacencyIterator () : _pos(0), _end(0), _value(0)
+    {}
+
+    /**
+     * constructor, positioned on the first neighbour of a row
+     * @param source the vertex the row belongs to, the first neighbour is stored relative to it
+     * @param begin the first byte of the row
+     * @param end one past the last byte of the row
+     */
+    CompressedAdjacencyIterator (std::size_t source, const std::uint8_t* begin, const std::uint8_t* end) : _pos(begin), _end(end), _value(0)
+    {
+        if(_pos != _end)
+        {
+            const std::uint8_t* p = _pos;
+            std::size_t z = decode_varint(p);
+            _value = source + ((z >> 1) ^ (0 - (z & 1))); //undo the zigzag, wrapping arithmetic gives source - d for odd z
+        }
+    }
+
+    /**
+     * dereference operator
+     * @return the neighbour currently pointed at
+     */
+    reference operator * () const
+    {
+        return _value;
+    }
+
+    /**
+     * pre-increment operator, decodes the next neighbour
+     * @return this CompressedAdjacencyIterator
+     */
+    CompressedAdjacencyIterator& operator ++ ()
+    {
+        while(*_pos++ & 0x80) //past the current neighbour, its value is known already
+        {}
+        if(_pos != _end)
+        {
+            const std::uint8_t* p = _pos;
+            _value += decode_varint(p) + 1;
+        }
+        return *this;
+    }
+
+    /**
+     * post-increment operator
+     * @return a copy of this CompressedAdjacencyIterator before it was incremented
+     */
+    CompressedAdjacencyIterator operator ++ (int)
+    {
+        CompressedAdjacencyIterator x = *this;
+        ++*this;
+        return x;
+    }
+
+    /**
+     * == operator for CompressedAdjacencyIterator
+     * @param lhs a CompressedAdjacencyIterator
+     * @param rhs a CompressedAdjacencyIterator
+     * @return a bool that indicates whether both point at the same neighbour
+     */
+    friend bool operator == (const CompressedAdjacencyIterator& lhs, const CompressedAdjacencyIterator& rhs)
+    {
+        return lhs._pos == rhs._pos;
+    }
+
+    private: //three words, it is copied into every frame of a depth-first traversal
+        const std::uint8_t* _pos; /*!< first byte of the current neighbour, _end past the last one */
+        const std::uint8_t* _end; /*!< one past the last byte of the row */
+        std::size_t _value; /*!< the current neighbour, decoded */
+};
+
+// ------------------------
+// CompressedEdgeIterator
+// ------------------------
+
+template <typename G>
+class CompressedEdgeIterator
+{
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef EdgeDescriptor value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const EdgeDescriptor* pointer;
+        typedef EdgeDescriptor reference;
+
+    /**
+     * default constructor
+     */
+    CompressedEdgeIterator () : _g(0), _source(0), _pos(), _end()
+    {}
+
+    /**
+     * constructor, positioned on the first edge whose source is at least s
+     * @param g the graph being walked
+     * @param s the first source to look at
+     */
+    CompressedEdgeIterator (const G* g, std::size_t s) : _g(g), _source(s), _pos(), _end()
+    {
+        skip_empty_rows();
+    }
+
+    /**
+     * dereference operator
+     * @return the edge_descriptor currently pointed at
+     */
+    reference operator * () const
+    {
+        return EdgeDescriptor(_source, *_pos);
+    }
+
+    /**
+     * pre-increment operator, moves to the next neighbour and then to the next non-empty row
+     * @return this CompressedEdgeIterator
+     */
+    CompressedEdgeIterator& operator ++ ()
+    {
+        if(++_pos == _end)
+        {
+            ++_source;
+            skip_empty_rows();
+        }
+        return *this;
+    }
+
+    /**
+     * post-increment operator
+     * @return a copy of this CompressedEdgeIterator before it was incremented
+     */
+    CompressedEdgeIterator operator ++ (int)
+    {
+        CompressedEdgeIterator x = *this;
+        ++*this;
+        return x;
+    }
+
+    /**
+     * == operator for CompressedEdgeIterator
+     * @param lhs a CompressedEdgeIterator
+     * @param rhs a CompressedEdgeIterator
+     * @return a bool that indicates whether the CompressedEdgeIterators point at the same edge, default constructed ones are equal
+     */
+    friend bool operator == (const CompressedEdgeIterator& lhs, const CompressedEdgeIterator& rhs)
+    {
+        return lhs._source == rhs._source && (lhs._g == 0 || lhs._source == num_vertices(*lhs._g) || lhs._pos == rhs._pos);
+    }
+
+    private:
+        const G* _g; /*!< the graph being walked */
+        std::size_t _source; /*!< source of the current edge, num_vertices once past the end */
+        typename G::adjacency_iterator _pos; /*!< target of the current edge inside its row */
+        typename G::adjacency_iterator _end; /*!< end of the current row */
+
+    /**
+     * advance _source until it names a row with at least one neighbour
+     */
+    void skip_empty_rows ()
+    {
+        while(_source < num_vertices(*_g))
+        {
+            std::pair<typename G::adjacency_iterator, typename G::adjacency_iterator> p = adjacent_vertices(_source, *_g);
+            if(p.first != p.second)
+            {
+                _pos = p.first;
+                _end = p.second;
+                return;
+            }
+            ++_source;
+        }
+    }
+};
+
+// ---------------
+// CompressedGraph
+// ---------------
+
+/**
+ * read-only directed graph, rows of delta encoded varints back to back in one byte array
+ * the memory is one offset per vertex plus about one or two bytes per edge when neighbours are close,
+ * against 8 bytes per edge for CsrGraph and more for Graph
+ */
+class CompressedGraph
+{
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef std::size_t vertex_descriptor;
+        typedef EdgeDescriptor edge_descriptor;
+
+        typedef boost::counting_iterator<vertex_descriptor> vertex_iterator;
+        typedef CompressedEdgeIterator<CompressedGraph> edge_iterator;
+        typedef CompressedAdjacencyIterator adjacency_iterator;
+
+        typedef std::size_t vertices_size_type;
+        typedef std::size_t edges_size_type;
+
+    public:
+        // -----------------
+        // adjacent_vertices
+        // -----------------
+
+        /**
+         * adjacent_vertices function
+         * the adjacent vertices are decoded one at a time, in increasing vertex_descriptor order
+         * @param v a vertex_descriptor
+         * @param g the graph where the vertex_descriptor is
+         * @return a pair of adjacency_iterators delimiting v's row
+         */
+        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor v, const CompressedGraph& g)
+        {
+            const std::uint8_t* b = g._bytes.data() + g._offsets[v];
+            const std::uint8_t* e = g._bytes.data() + g._offsets[v + 1];
+            return std::make_pair(adjacency_iterator(v, b, e), adjacency_iterator(v, e, e));
+        }
+
+        // ----
+        // edge
+        // ----
+
+        /**
+         * edge function
+         * the row is decoded up to v2, O(deg(v1))
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @param g the graph where the vertex_descriptor is
+         * @return a pair, where first is the edge_descriptor between the vertices, second is a bool indicates whether the edge_descriptor exists in the graph
+         */
+        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor v1, vertex_descriptor v2, const CompressedGraph& g)
+        {
+            edge_descriptor e(v1, v2);
+            if(v1 >= num_vertices(g))
+            {
+                return std::make_pair(e, false);
+            }
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v1, g);
+            while(p.first != p.second && *p.first < v2)
+            {
+                ++p.first;
+            }
+            return std::make_pair(e, p.first != p.second && *p.first == v2);
+        }
+
+        // -----
+        // edges
+        // -----
+
+        /**
+         * edges function
+         * @param g a CompressedGraph
+         * @return a pair of edge_iterator visiting the edges by increasing source, then by increasing target
+         */
+        friend std::pair<edge_iterator, edge_iterator> edges (const CompressedGraph& g)
+        {
+            return std::make_pair(edge_iterator(&g, 0), edge_iterator(&g, num_vertices(g)));
+        }
+
+        // ---------
+        // num_edges
+        // ---------
+
+        /**
+         * num_edges function
+         * @param g a CompressedGraph
+         * @return the number of edges in the given graph
+         */
+        friend edges_size_type num_edges (const CompressedGraph& g)
+        {
+            return g._num_edges;
+        }
+
+        // ------------
+        // num_vertices
+        // ------------
+
+        /**
+         * num_vertices function
+         * @param g a CompressedGraph
+         * @return the number of vertices in the given graph
+         */
+        friend vertices_size_type num_vertices (const CompressedGraph& g)
+        {
+            return g._offsets.size() - 1;
+        }
+
+        // ------
+        // source
+        // ------
+
+        /**
+         * source function
+         * @param e an edge_descriptor
+         * @return the source vertex_descriptor of a given edge_descriptor
+         */
+        friend vertex_descriptor source (edge_descriptor e, const CompressedGraph&)
+        {
+            return e._source;
+        }
+
+        // ------
+        // target
+        // ------
+
+        /**
+         * target function
+         * @param e an edge_descriptor
+         * @return the target vertex_descriptor of a given edge_descriptor
+         */
+        friend vertex_descriptor target (edge_descriptor e, const CompressedGraph&)
+        {
+            return e._target;
+        }
+
+        // ------
+        // vertex
+        // ------
+
+        /**
+         * vertex function
+         * @param nth integral value represents the n term index of the vertex
+         * @return the nth vertex_descriptor of the graph
+         */
+        friend vertex_descriptor vertex (vertices_size_type nth, const CompressedGraph&)
+        {
+            return nth;
+        }
+
+        // --------
+        // vertices
+        // --------
+
+        /**
+         * vertices function
+         * @param g a CompressedGraph
+         * @return a pair of vertex_iterator in which the first can travel to the second one the eventually visits all the vertices in the given graph
+         */
+        friend std::pair<vertex_iterator, vertex_iterator> vertices (const CompressedGraph& g)
+        {
+            return std::make_pair(vertex_iterator(0), vertex_iterator(num_vertices(g)));
+        }
+
+        // -----
+        // bytes
+        // -----
+
+        /**
+         * bytes function
+         * @param g a CompressedGraph
+         * @return the heap held by the graph
+         */
+        friend std::size_t bytes (const CompressedGraph& g)
+        {
+            return g._offsets.capacity() * sizeof(std::size_t) + g._bytes.capacity();
+        }
+
+    private:
+        // ----
+        // data
+        // ----
+
+        std::vector<std::size_t> _offsets; /*!< _offsets[v] is the index in _bytes of v's row, one extra entry at the end */
+
+        std::vector<std::uint8_t> _bytes; /*!< the encoded rows, back to back */
+
+        edges_size_type _num_edges; /*!< number of edges over all the rows */
+
+        // ------
+        // encode
+        // ------
+
+        /**
+         * encode every row of a graph whose rows are sorted
+         * @param g a graph
+         */
+        template <typename G>
+        void encode (const G& g)
+        {
+            typedef typename G::adjacency_iterator iterator;
+            _offsets.reserve(vertex_index_bound(g) + 1);
+            _bytes.reserve(num_edges(g) * 2);
+            for(vertex_descriptor v = 0; v < vertex_index_bound(g); ++v)
+            {
+                std::pair<iterator, iterator> p = adjacent_vertices(v, g);
+                if(p.first != p.second)
+                {
+                    vertex_descriptor previous = *p.first;
+                    std::size_t d = previous - v;
+                    encode_varint(previous >= v ? d << 1 : ((0 - d) << 1) - 1, _bytes); //zigzag: 0, -1, 1, -2 ... as 0, 1, 2, 3 ...
+                    for(++p.first; p.first != p.second; ++p.first)
+                    {
+                        encode_varint(*p.first - previous - 1, _bytes);
+                        previous = *p.first;
+                    }
+                }
+                _offsets.push_back(_bytes.size());
+            }
+            _bytes.shrink_to_fit();
+            _num_edges = num_edges(g);
+        }
+
+        // -----
+        // valid
+        // -----
+
+        /**
+         * valid function
+         */
+        bool valid () const
+        {
+            return !_offsets.empty() && _offsets.front() == 0 && _offsets.back() == _bytes.size();
+        }
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * default constructor
+         */
+        CompressedGraph () : _offsets(1, 0), _bytes(), _num_edges(0)
+        {
+            assert(valid());
+        }
+
+        /**
+         * encode a Graph, O(V + E)
+         * @param g a Graph, whatever its storage selectors
+         */
+        template <typename OutEdgeS, typename VertexS, typename DirectedS, typename Alloc>
+        explicit CompressedGraph (const basic_graph<OutEdgeS, VertexS, DirectedS, Alloc>& g) : _offsets(1, 0), _bytes(), _num_edges(0)
+        {
+            encode(g);
+            assert(valid());
+        }
+
+        /**
+         * encode a CsrGraph, O(V + E)
+         * @param g a CsrGraph
+         */
+        explicit CompressedGraph (const CsrGraph& g) : _offsets(1, 0), _bytes(), _num_edges(0)
+        {
+            encode(g);
+            assert(valid());
+        }
+
+        /**
+         * bulk constructor, same graph as a Graph built from the range
+         * @param first a forward iterator to std::pair<vertex_descriptor, vertex_descriptor>
+         * @param last end of the range
+         * @param n the minimum number of vertices
+         */
+        template <typename FI>
+        CompressedGraph (FI first, FI last, vertices_size_type n = 0) : _offsets(1, 0), _bytes(), _num_edges(0)
+        {
+            encode(CsrGraph(first, last, n));
+            assert(valid());
+        }
+
+        /**
+         * equal operator
+         * @lhs a CompressedGraph
+         * @rhs a CompressedGraph
+         */
+        friend bool operator == (const CompressedGraph& lhs, const CompressedGraph& rhs)
+        {
+            return lhs._offsets == rhs._offsets && lhs._bytes == rhs._bytes;
+        }
+
+        // Default copy, destructor, and copy assignment
+        // CompressedGraph  (const CompressedGraph&);
+        // ~CompressedGraph ();
+        // CompressedGraph& operator = (const CompressedGraph&);
+};
+
+#endif // GraphCompressed_h
@@ -0,0 +1,530 @@
+// --------------------------------
+// projects/graph/GraphConcurrent.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// --------------------------------
+
+#ifndef GraphConcurrent_h
+#define GraphConcurrent_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // binary_search, min
+#include <atomic>    // atomic_load, atomic_store
+#include <cassert>   // assert
+#include <cstddef>   // size_t
+#include <memory>    // make_shared, shared_ptr
+#include <mutex>     // lock_guard, mutex
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include "boost/iterator/counting_iterator.hpp" // counting_iterator
+
+#include "Graph.h"
+#include "GraphCompressed.h" // CompressedEdgeIterator
+
+/*
+A ConcurrentGraph is written by one thread at a time and read by any number of threads.
+Writers add edges and vertices to a private basic_graph, which nobody else ever sees, and
+publish() freezes it into an immutable GraphSnapshot:
+
+    ConcurrentGraph<> cg;
+    add_edge(0, 1, cg);                                     //writer
+    publish(cg);
+    ConcurrentGraph<>::snapshot_type s = snapshot(cg);      //any reader
+    topological_sort(*s, out);
+
+A snapshot is a shared_ptr to a GraphSnapshot, so every query a reader runs on it sees the
+same graph however many times the writer publishes meanwhile, and the snapshot is freed when
+the last reader lets go of it. A snapshot is never built while a reader waits: taking one
+copies the shared_ptr with std::atomic_load, and publishing swaps the new one in with
+std::atomic_store. libstdc++ makes both lock a mutex, picked from a small global pool by the
+address of the shared_ptr, for the copy or the swap only, so a reader can wait for another
+reader or for a swap, never for a snapshot being built.
+The rows of a GraphSnapshot are cut into blocks of 256 vertices, each a small compressed sparse
+row layout behind its own shared_ptr. publish() rebuilds only the blocks the writers touched since
+the last publish, and the new vertices, and shares every other block with the previous snapshot:
+O(V / 256) for the table of blocks plus O(256 + E_b) per touched block of E_b edges, rather than a
+copy of the whole graph. Publishing after each of E single-edge updates is no longer quadratic in
+the number of edges.
+*/
+
+// -------------
+// GraphSnapshot
+// -------------
+
+/**
+ * immutable graph published by a ConcurrentGraph
+ * the rows are held in blocks of block_size consecutive vertices, each a compressed sparse row layout,
+ * and a snapshot shares the blocks that did not change with the one published before it
+ */
+class GraphSnapshot
+{
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef std::size_t vertex_descriptor;
+        typedef EdgeDescriptor edge_descriptor;
+
+        typedef boost::counting_iterator<vertex_descriptor> vertex_iterator;
+        typedef CompressedEdgeIterator<GraphSnapshot> edge_iterator;
+        typedef std::vector<vertex_descriptor>::const_iterator adjacency_iterator;
+
+        typedef std::size_t vertices_size_type;
+        typedef std::size_t edges_size_type;
+
+        static const std::size_t block_shift = 8; /*!< log2 of the number of vertices in a block */
+
+    public:
+        // -----------------
+        // adjacent_vertices
+        // -----------------
+
+        /**
+         * adjacent_vertices function
+         * the adjacent vertices are visited in increasing vertex_descriptor order
+         * @param v a vertex_descriptor
+         * @param g the graph where the vertex_descriptor is
+         * @return a pair of adjacency_iterators delimiting v's row
+         */
+        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor v, const GraphSnapshot& g)
+        {
+            const Block& b = *g._blocks[v >> block_shift];
+            std::size_t i = v & ((std::size_t(1) << block_shift) - 1);
+            return std::make_pair(b.targets.begin() + b.offsets[i], b.targets.begin() + b.offsets[i + 1]);
+        }
+
+        // ----
+        // edge
+        // ----
+
+        /**
+         * edge function
+         * binary search in v1's row, O(log deg(v1))
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @param g the graph where the vertex_descriptor is
+         * @return a pair, where first is the edge_descriptor between the vertices, second is a bool indicates whether the edge_descriptor exists in the graph
+         */
+        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor v1, vertex_descriptor v2, const GraphSnapshot& g)
+        {
+            edge_descriptor e(v1, v2);
+            if(v1 >= num_vertices(g))
+            {
+                return std::make_pair(e, false);
+            }
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v1, g);
+            return std::make_pair(e, std::binary_search(p.first, p.second, v2));
+        }
+
+        // -----
+        // edges
+        // -----
+
+        /**
+         * edges function
+         * @param g a GraphSnapshot
+         * @return a pair of edge_iterator visiting the edges by increasing source, then by increasing target
+         */
+        friend std::pair<edge_iterator, edge_iterator> edges (const GraphSnapshot& g)
+        {
+            return std::make_pair(edge_iterator(&g, 0), edge_iterator(&g, num_vertices(g)));
+        }
+
+        // ---------
+        // num_edges
+        // ---------
+
+        /**
+         * num_edges function
+         * @param g a GraphSnapshot
+         * @return the number of edges in the given graph
+         */
+        friend edges_size_type num_edges (const GraphSnapshot& g)
+        {
+            return g._num_edges;
+        }
+
+        // ------------
+        // num_vertices
+        // ------------
+
+        /**
+         * num_vertices function
+         * @param g a GraphSnapshot
+         * @return the number of vertices in the given graph
+         */
+        friend vertices_size_type num_vertices (const GraphSnapshot& g)
+        {
+            return g._num_vertices;
+        }
+
+        // ------
+        // source
+        // ------
+
+        /**
+         * source function
+         * @param e an edge_descriptor
+         * @return the source vertex_descriptor of a given edge_descriptor
+         */
+        friend vertex_descriptor source (edge_descriptor e, const GraphSnapshot&)
+        {
+            return e._source;
+        }
+
+        // ------
+        // target
+        // ------
+
+        /**
+         * target function
+         * @param e an edge_descriptor
+         * @return the target vertex_descriptor of a given edge_descriptor
+         */
+        friend vertex_descriptor target (edge_descriptor e, const GraphSnapshot&)
+        {
+            return e._target;
+        }
+
+        // ------
+        // vertex
+        // ------
+
+        /**
+         * vertex function
+         * @param nth integral value represents the n term index of the vertex
+         * @return the nth vertex_descriptor of the graph
+         */
+        friend vertex_descriptor vertex (vertices_size_type nth, const GraphSnapshot&)
+        {
+            return nth;
+        }
+
+        // --------
+        // vertices
+        // --------
+
+        /**
+         * vertices function
+         * @param g a GraphSnapshot
+         * @return a pair of vertex_iterator in which the first can travel to the second one the eventually visits all the vertices in the given graph
+         */
+        friend std::pair<vertex_iterator, vertex_iterator> vertices (const GraphSnapshot& g)
+        {
+            return std::make_pair(vertex_iterator(0), vertex_iterator(num_vertices(g)));
+        }
+
+    private:
+        // -----
+        // Block
+        // -----
+
+        /**
+         * the rows of up to 2^block_shift consecutive vertices, laid out like a CsrGraph
+         */
+        struct Block
+        {
+            std::vector<std::size_t> offsets; /*!< offsets[i] is the index in targets of the first target of the block's i-th vertex */
+            std::vector<vertex_descriptor> targets; /*!< the targets of the block's rows, back to back */
+        };
+
+        // ----
+        // data
+        // ----
+
+        std::vector< std::shared_ptr<const Block> > _blocks; /*!< _blocks[v >> block_shift] holds v's row, shared between snapshots */
+
+        vertices_size_type _num_vertices; /*!< number of vertices */
+
+        edges_size_type _num_edges; /*!< number of edges, summed over the blocks */
+
+        // ----------
+        // make_block
+        // ----------
+
+        /**
+         * copy the rows of a block of vertices out of a graph
+         * @param g a graph
+         * @param k the index of the block
+         * @param n the number of vertices of g
+         * @return the rows of the vertices k << block_shift up to n, at most 2^block_shift of them
+         */
+        template <typename G>
+        static std::shared_ptr<const Block> make_block (const G& g, std::size_t k, vertices_size_type n)
+        {
+            typedef typename G::adjacency_iterator adjacency_iterator;
+
+            std::shared_ptr<Block> b = std::make_shared<Block>();
+            vertex_descriptor first = k << block_shift;
+            vertex_descriptor last = std::min(n, (k + 1) << block_shift);
+            b->offsets.reserve(last - first + 1);
+            b->offsets.push_back(0);
+            for(vertex_descriptor v = first; v < last; ++v)
+            {
+                std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, g);
+                b->targets.insert(b->targets.end(), p.first, p.second);
+                b->offsets.push_back(b->targets.size());
+            }
+            return b;
+        }
+
+        // -----
+        // valid
+        // -----
+
+        /**
+         * valid function
+         */
+        bool valid () const
+        {
+            return _blocks.size() == ((_num_vertices + (std::size_t(1) << block_shift) - 1) >> block_shift);
+        }
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * default constructor, no vertices
+         */
+        GraphSnapshot () : _blocks(), _num_vertices(0), _num_edges(0)
+        {
+            assert(valid());
+        }
+
+        /**
+         * copy a graph, every block built, O(V + E)
+         * the vertex_descriptors are kept, a vertex removed from g is an isolated vertex here
+         * @param g a Graph, or any graph with sorted rows
+         */
+        template <typename G>
+        explicit GraphSnapshot (const G& g) : _blocks(), _num_vertices(vertex_index_bound(g)), _num_edges(0)
+        {
+            _blocks.reserve((_num_vertices + (std::size_t(1) << block_shift) - 1) >> block_shift);
+            while((_blocks.size() << block_shift) < _num_vertices)
+            {
+                _blocks.push_back(make_block(g, _blocks.size(), _num_vertices));
+                _num_edges += _blocks.back()->targets.size();
+            }
+            assert(valid());
+        }
+
+        /**
+         * the next snapshot of a graph that only grew, or changed the rows of the touched blocks, since previous was taken from it
+         * O(V / 2^block_shift) for the table of blocks plus the size of the blocks built again
+         * @param g the graph previous was taken from, vertices never renumbered since
+         * @param previous the last snapshot of g, every block it has that is neither touched nor its last one is shared
+         * @param touched the indices of the blocks whose rows changed, each at most once
+         */
+        template <typename G>
+        GraphSnapshot (const G& g, const GraphSnapshot& previous, const std::vector<std::size_t>& touched) :
+            _blocks(previous._blocks), _num_vertices(vertex_index_bound(g)), _num_edges(previous._num_edges)
+        {
+            //the last block of previous may be partial, it is built again with the new ones
+            std::size_t grown = previous._num_vertices >> block_shift;
+            for(std::size_t i = 0; i < touched.size(); ++i)
+            {
+                std::size_t k = touched[i];
+                if(k < grown)
+                {
+                    _num_edges -= _blocks[k]->targets.size();
+                    _blocks[k] = make_block(g, k, _num_vertices);
+                    _num_edges += _blocks[k]->targets.size();
+                }
+            }
+            _blocks.resize(grown);
+            while((_blocks.size() << block_shift) < _num_vertices)
+            {
+                std::size_t k = _blocks.size();
+                if(k < previous._blocks.size())
+                {
+                    _num_edges -= previous._blocks[k]->targets.size();
+                }
+                _blocks.push_back(make_block(g, k, _num_vertices));
+                _num_edges += _blocks.back()->targets.size();
+            }
+            assert(valid());
+        }
+};
+
+// ---------------
+// ConcurrentGraph
+// ---------------
+
+template <typename G = Graph>
+class ConcurrentGraph
+{
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef G graph_type;
+        typedef typename G::vertex_descriptor vertex_descriptor;
+        typedef typename G::edge_descriptor edge_descriptor;
+        typedef std::shared_ptr<const GraphSnapshot> snapshot_type;
+
+    public:
+        // --------
+        // add_edge
+        // --------
+
+        /**
+         * add an edge to the writer's graph, readers see it after the next publish
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @param g the ConcurrentGraph
+         * @return as add_edge on the underlying graph
+         */
+        friend std::pair<edge_descriptor, bool> add_edge (vertex_descriptor v1, vertex_descriptor v2, ConcurrentGraph& g)
+        {
+            std::lock_guard<std::mutex> lock(g._write_mutex);
+            std::pair<edge_descriptor, bool> p = add_edge(v1, v2, g._graph);
+            if(p.second)
+            {
+                g.touch(v1);
+            }
+            return p;
+        }
+
+        // ---------
+        // add_edges
+        // ---------
+
+        /**
+         * add a range of edges to the writer's graph, readers see them after the next publish
+         * @param g the ConcurrentGraph
+         * @param first a forward iterator to std::pair<vertex_descriptor, vertex_descriptor>
+         * @param last end of the range
+         * @return the number of edges that were not already in the graph
+         */
+        template <typename FI>
+        friend std::size_t add_edges (ConcurrentGraph& g, FI first, FI last)
+        {
+            std::lock_guard<std::mutex> lock(g._write_mutex);
+            for(FI i = first; i != last; ++i)
+            {
+                g.touch(i->first);
+            }
+            return add_edges(g._graph, first, last);
+        }
+
+        // ----------
+        // add_vertex
+        // ----------
+
+        /**
+         * add a vertex to the writer's graph, readers see it after the next publish
+         * @param g the ConcurrentGraph
+         * @return the vertex_descriptor added
+         */
+        friend vertex_descriptor add_vertex (ConcurrentGraph& g)
+        {
+            std::lock_guard<std::mutex> lock(g._write_mutex);
+            return add_vertex(g._graph);
+        }
+
+        // -------
+        // publish
+        // -------
+
+        /**
+         * make everything written so far visible to the readers
+         * only the blocks of rows written since the last publish are copied, the others are shared with the last snapshot
+         * the snapshot is built aside and swapped in, readers keep the one they hold
+         * @param g the ConcurrentGraph
+         * @return the snapshot published
+         */
+        friend snapshot_type publish (ConcurrentGraph& g)
+        {
+            std::lock_guard<std::mutex> lock(g._write_mutex);
+            snapshot_type s = std::make_shared<const GraphSnapshot>(g._graph, *std::atomic_load(&g._snapshot), g._touched_blocks);
+            std::atomic_store(&g._snapshot, s);
+            for(std::size_t i = 0; i < g._touched_blocks.size(); ++i)
+            {
+                g._touched[g._touched_blocks[i]] = false;
+            }
+            g._touched_blocks.clear();
+            return s;
+        }
+
+        // --------
+        // snapshot
+        // --------
+
+        /**
+         * the last graph published, safe to call from any thread at any time
+         * @param g the ConcurrentGraph
+         * @return an immutable graph that stays valid as long as it is held
+         */
+        friend snapshot_type snapshot (const ConcurrentGraph& g)
+        {
+            return std::atomic_load(&g._snapshot);
+        }
+
+    private:
+        // ----
+        // data
+        // ----
+
+        std::mutex _write_mutex; /*!< one writer at a time, readers never take it */
+
+        G _graph; /*!< the writers' graph, only touched under _write_mutex */
+
+        snapshot_type _snapshot; /*!< the last graph published, only read and written with atomic_load and atomic_store */
+
+        std::vector<char> _touched; /*!< _touched[k] tells whether a row of block k changed since the last publish, only touched under _write_mutex */
+
+        std::vector<std::size_t> _touched_blocks; /*!< the k for which _touched[k] is set, the blocks publish builds again */
+
+        ConcurrentGraph (const ConcurrentGraph&);
+        ConcurrentGraph& operator = (const ConcurrentGraph&);
+
+        // -----
+        // touch
+        // -----
+
+        /**
+         * record that the row of v changed, so that its block is built again by the next publish
+         * @param v a vertex_descriptor
+         */
+        void touch (vertex_descriptor v)
+        {
+            std::size_t k = v >> GraphSnapshot::block_shift;
+            if(k >= _touched.size())
+            {
+                _touched.resize(k + 1, false);
+            }
+            if(!_touched[k])
+            {
+                _touched[k] = true;
+                _touched_blocks.push_back(k);
+            }
+        }
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * default constructor, the first snapshot is the empty graph
+         */
+        ConcurrentGraph () : _write_mutex(), _graph(), _snapshot(std::make_shared<const GraphSnapshot>()), _touched(), _touched_blocks()
+        {}
+
+        /**
+         * constructor
+         * @param g the graph the writers start from, published at once
+         */
+        explicit ConcurrentGraph (const G& g) : _write_mutex(), _graph(g), _snapshot(std::make_shared<const GraphSnapshot>(g)), _touched(), _touched_blocks()
+        {}
+};
+
+#endif // GraphConcurrent_h
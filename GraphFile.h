@@ -0,0 +1,476 @@
+// --------------------------
+// projects/graph/GraphFile.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// --------------------------
+
+#ifndef GraphFile_h
+#define GraphFile_h
+
+// --------
+// includes
+// --------
+
+#include <cstddef>   // size_t
+#include <cstdint>   // uint32_t, uint64_t
+#include <cstring>   // memcmp, memcpy
+#include <fstream>   // ofstream
+#include <stdexcept> // runtime_error
+#include <string>    // string
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+
+#include "Graph.h"
+
+/*
+Layout of a graph file, every field in the byte order of the machine that wrote it:
+    header          64 bytes, see GraphFileHeader
+    offsets         (num_vertices + 1) uint64, offsets[v] is where v's targets start
+    targets         num_edges uint64, each row sorted in increasing order
+The checksum covers the offsets and the targets. The header records the byte order, and a file
+written on a machine of the other byte order is refused rather than misread.
+*/
+
+static_assert(sizeof(std::size_t) == sizeof(std::uint64_t), "graph files store vertex_descriptors as 64 bit words");
+
+// ---------------
+// GraphFileHeader
+// ---------------
+
+struct GraphFileHeader
+{
+    char          magic[8];     /*!< "GRAPHCSR" */
+    std::uint32_t version;      /*!< format version, see graph_file_version */
+    std::uint32_t header_size;  /*!< sizeof(GraphFileHeader) */
+    std::uint64_t num_vertices;
+    std::uint64_t num_edges;
+    std::uint64_t checksum;     /*!< graph_file_checksum of offsets then targets */
+    std::uint64_t byte_order;   /*!< graph_file_byte_order, as the writer stores it */
+    std::uint64_t reserved[2];  /*!< zero */
+};
+
+static_assert(sizeof(GraphFileHeader) == 64, "the header is 64 bytes, which keeps the arrays after it aligned");
+
+const char graph_file_magic[8] = {'G', 'R', 'A', 'P', 'H', 'C', 'S', 'R'};
+const std::uint32_t graph_file_version = 2;
+const std::uint64_t graph_file_byte_order = 0x0102030405060708ULL; /*!< reads 0x0807060504030201 in the other byte order */
+
+// ---------------
+// GraphFileError
+// ---------------
+
+/**
+ * thrown when a graph file can not be written, opened or mapped, or does not pass validation
+ */
+class GraphFileError : public std::runtime_error
+{
+    public:
+    /**
+     * constructor
+     * @param path the file concerned
+     * @param what what went wrong
+     */
+    GraphFileError (const std::string& path, const std::string& what) : std::runtime_error(path + ": " + what)
+    {}
+};
+
+// -------------------
+// graph_file_checksum
+// -------------------
+
+/**
+ * 64-bit FNV-1a applied to whole 8-byte words, cheap enough to run over a file on every open
+ * @param h the checksum so far
+ * @param b the first word
+ * @param e one past the last word
+ * @return the checksum including [b, e)
+ */
+inline std::uint64_t graph_file_checksum (std::uint64_t h, const std::uint64_t* b, const std::uint64_t* e)
+{
+    for(; b != e; ++b)
+    {
+        h = (h ^ *b) * 1099511628211ULL;
+    }
+    return h;
+}
+
+const std::uint64_t graph_file_checksum_seed = 14695981039346656037ULL;
+
+// ----------
+// save_graph
+// ----------
+
+/**
+ * write a graph in the graph file format
+ * the rows are written sorted, whatever order adjacent_vertices gives them in
+ * @param g a Graph, or any type with the same free functions
+ * @param path the file to create or overwrite
+ * @throws GraphFileError if the file can not be written
+ */
+template <typename G>
+void save_graph (const G& g, const std::string& path)
+{
+    typedef typename G::adjacency_iterator adjacency_iterator;
+
+    std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+    GraphFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, graph_file_magic, sizeof(header.magic));
+    header.version = graph_file_version;
+    header.header_size = sizeof(GraphFileHeader);
+    header.byte_order = graph_file_byte_order;
+    header.num_vertices = vertex_index_bound(g); //a removed vertex is saved as an isolated one
+    header.num_edges = num_edges(g);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header)); //placeholder until the checksum is known
+
+    std::uint64_t checksum = graph_file_checksum_seed;
+    std::vector<std::uint64_t> offsets(1, 0);
+    offsets.reserve(header.num_vertices + 1);
+    for(std::size_t v = 0; v < header.num_vertices; ++v)
+    {
+        std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, g);
+        offsets.push_back(offsets.back() + std::distance(p.first, p.second));
+    }
+    checksum = graph_file_checksum(checksum, offsets.data(), offsets.data() + offsets.size());
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(std::uint64_t));
+
+    std::vector<std::uint64_t> row;
+    for(std::size_t v = 0; v < header.num_vertices; ++v)
+    {
+        std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v, g);
+        row.assign(p.first, p.second);
+        std::sort(row.begin(), row.end());
+        checksum = graph_file_checksum(checksum, row.data(), row.data() + row.size());
+        out.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(std::uint64_t));
+    }
+
+    header.checksum = checksum;
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if(!out)
+    {
+        throw GraphFileError(path, "write failed");
+    }
+}
+
+// -----------
+// MappedGraph
+// -----------
+
+/**
+ * read-only graph answering straight from a memory-mapped graph file
+ * opening costs one mmap plus the validation, nothing is parsed or copied,
+ * pages are read in by the kernel as the traversals touch them
+ */
+class MappedGraph
+{
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef std::size_t vertex_descriptor;
+        typedef EdgeDescriptor edge_descriptor;
+
+        typedef boost::counting_iterator<vertex_descriptor> vertex_iterator;
+        typedef CsrEdgeIterator edge_iterator;
+        typedef const vertex_descriptor* adjacency_iterator;
+
+        typedef std::size_t vertices_size_type;
+        typedef std::size_t edges_size_type;
+
+    public:
+        // -----------------
+        // adjacent_vertices
+        // -----------------
+
+        /**
+         * adjacent_vertices function
+         * the adjacent vertices are visited in increasing vertex_descriptor order
+         * @param v a vertex_descriptor
+         * @param g the graph where the vertex_descriptor is
+         * @return a pair of adjacency_iterators delimiting v's row in the mapping
+         */
+        friend std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor v, const MappedGraph& g)
+        {
+            return std::make_pair(g._targets + g._offsets[v], g._targets + g._offsets[v + 1]);
+        }
+
+        // ----
+        // edge
+        // ----
+
+        /**
+         * edge function
+         * binary search in v1's row, O(log deg(v1))
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @param g the graph where the vertex_descriptor is
+         * @return a pair, where first is the edge_descriptor between the vertices, second is a bool indicates whether the edge_descriptor exists in the graph
+         */
+        friend std::pair<edge_descriptor, bool> edge (vertex_descriptor v1, vertex_descriptor v2, const MappedGraph& g)
+        {
+            edge_descriptor e(v1, v2);
+            if(v1 >= num_vertices(g))
+            {
+                return std::make_pair(e, false);
+            }
+            std::pair<adjacency_iterator, adjacency_iterator> p = adjacent_vertices(v1, g);
+            return std::make_pair(e, std::binary_search(p.first, p.second, v2));
+        }
+
+        // -----
+        // edges
+        // -----
+
+        /**
+         * edges function
+         * @param g a MappedGraph
+         * @return a pair of edge_iterator visiting the edges by increasing source, then by increasing target
+         */
+        friend std::pair<edge_iterator, edge_iterator> edges (const MappedGraph& g)
+        {
+            edge_iterator b(g._offsets, g._targets, 0, g._num_edges, g._num_vertices);
+            edge_iterator e(g._offsets, g._targets, g._num_edges, g._num_edges, g._num_vertices);
+            return std::make_pair(b, e);
+        }
+
+        // ---------
+        // num_edges
+        // ---------
+
+        /**
+         * num_edges function
+         * @param g a MappedGraph
+         * @return the number of edges in the given graph
+         */
+        friend edges_size_type num_edges (const MappedGraph& g)
+        {
+            return g._num_edges;
+        }
+
+        // ------------
+        // num_vertices
+        // ------------
+
+        /**
+         * num_vertices function
+         * @param g a MappedGraph
+         * @return the number of vertices in the given graph
+         */
+        friend vertices_size_type num_vertices (const MappedGraph& g)
+        {
+            return g._num_vertices;
+        }
+
+        // ------
+        // source
+        // ------
+
+        /**
+         * source function
+         * @param e an edge_descriptor
+         * @return the source vertex_descriptor of a given edge_descriptor
+         */
+        friend vertex_descriptor source (edge_descriptor e, const MappedGraph&)
+        {
+            return e._source;
+        }
+
+        // ------
+        // target
+        // ------
+
+        /**
+         * target function
+         * @param e an edge_descriptor
+         * @return the target vertex_descriptor of a given edge_descriptor
+         */
+        friend vertex_descriptor target (edge_descriptor e, const MappedGraph&)
+        {
+            return e._target;
+        }
+
+        // ------
+        // vertex
+        // ------
+
+        /**
+         * vertex function
+         * @param nth integral value represents the n term index of the vertex
+         * @return the nth vertex_descriptor of the graph
+         */
+        friend vertex_descriptor vertex (vertices_size_type nth, const MappedGraph&)
+        {
+            return nth;
+        }
+
+        // --------
+        // vertices
+        // --------
+
+        /**
+         * vertices function
+         * @param g a MappedGraph
+         * @return a pair of vertex_iterator in which the first can travel to the second one the eventually visits all the vertices in the given graph
+         */
+        friend std::pair<vertex_iterator, vertex_iterator> vertices (const MappedGraph& g)
+        {
+            return std::make_pair(vertex_iterator(0), vertex_iterator(g._num_vertices));
+        }
+
+    private:
+        // ----
+        // data
+        // ----
+
+        void* _mapping; /*!< start of the mapped file */
+        std::size_t _size; /*!< length of the mapping in bytes */
+        vertices_size_type _num_vertices;
+        edges_size_type _num_edges;
+        const std::size_t* _offsets; /*!< row offsets, inside the mapping */
+        const vertex_descriptor* _targets; /*!< packed rows, inside the mapping */
+
+        MappedGraph (const MappedGraph&);
+        MappedGraph& operator = (const MappedGraph&);
+
+        // --------
+        // validate
+        // --------
+
+        /**
+         * check the header, the sizes, the structure and, if asked for, the checksum
+         * the structure is always checked: a checksum only says the bytes are the ones the writer hashed,
+         * not that the writer got the rows right, and a bad row would be read outside the mapping
+         * @param path the file, for the error messages
+         * @param verify_checksum whether to also check the checksum, a second read of the whole file
+         * @throws GraphFileError if anything is off
+         */
+        void validate (const std::string& path, bool verify_checksum)
+        {
+            const GraphFileHeader& header = *static_cast<const GraphFileHeader*>(_mapping);
+            if(std::memcmp(header.magic, graph_file_magic, sizeof(header.magic)) != 0)
+            {
+                throw GraphFileError(path, "not a graph file");
+            }
+            if(header.byte_order == 0x0807060504030201ULL)
+            {
+                throw GraphFileError(path, "written on a machine of the other byte order");
+            }
+            if(header.version != graph_file_version || header.header_size != sizeof(GraphFileHeader) || header.byte_order != graph_file_byte_order)
+            {
+                throw GraphFileError(path, "unsupported graph file version " + std::to_string(header.version));
+            }
+            _num_vertices = header.num_vertices;
+            _num_edges = header.num_edges;
+            std::uint64_t words = (_size - sizeof(GraphFileHeader)) / sizeof(std::uint64_t);
+            if(_num_vertices >= words || _num_edges != words - _num_vertices - 1 || (_size - sizeof(GraphFileHeader)) % sizeof(std::uint64_t) != 0)
+            {
+                throw GraphFileError(path, "size does not match the header");
+            }
+            _offsets = reinterpret_cast<const std::size_t*>(static_cast<const char*>(_mapping) + sizeof(GraphFileHeader));
+            _targets = _offsets + _num_vertices + 1;
+            if(_offsets[0] != 0 || _offsets[_num_vertices] != _num_edges)
+            {
+                throw GraphFileError(path, "offsets do not match the header");
+            }
+            validate_structure(path);
+            if(verify_checksum && graph_file_checksum(graph_file_checksum_seed, _offsets, _targets + _num_edges) != header.checksum)
+            {
+                throw GraphFileError(path, "checksum mismatch");
+            }
+        }
+
+        // ------------------
+        // validate_structure
+        // ------------------
+
+        /**
+         * check that the offsets never decrease, so every row lies inside the targets, and that every target is a vertex
+         * O(V + E), what makes the file safe to traverse whatever wrote it
+         * @param path the file, for the error messages
+         * @throws GraphFileError if a row or a target is out of range
+         */
+        void validate_structure (const std::string& path) const
+        {
+            for(std::size_t v = 0; v < _num_vertices; ++v)
+            {
+                if(_offsets[v] > _offsets[v + 1])
+                {
+                    throw GraphFileError(path, "offsets decrease at vertex " + std::to_string(v));
+                }
+            }
+            for(std::size_t i = 0; i < _num_edges; ++i)
+            {
+                if(_targets[i] >= _num_vertices)
+                {
+                    throw GraphFileError(path, "target out of range at edge " + std::to_string(i));
+                }
+            }
+        }
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * map a graph file
+         * @param path the file written by save_graph
+         * @param verify_checksum whether to check the checksum too, the structure is checked either way,
+         * each reads the whole file once
+         * @throws GraphFileError if the file can not be mapped or is not a valid graph file
+         */
+        explicit MappedGraph (const std::string& path, bool verify_checksum = true) :
+            _mapping(MAP_FAILED), _size(0), _num_vertices(0), _num_edges(0), _offsets(0), _targets(0)
+        {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if(fd < 0)
+            {
+                throw GraphFileError(path, "can not open");
+            }
+            struct stat st;
+            if(::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                throw GraphFileError(path, "can not stat");
+            }
+            _size = st.st_size;
+            if(_size < sizeof(GraphFileHeader))
+            {
+                ::close(fd);
+                throw GraphFileError(path, "too short for a graph file header");
+            }
+            _mapping = ::mmap(0, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if(_mapping == MAP_FAILED)
+            {
+                throw GraphFileError(path, "can not map");
+            }
+            try
+            {
+                validate(path, verify_checksum);
+            }
+            catch(...)
+            {
+                ::munmap(_mapping, _size);
+                throw;
+            }
+        }
+
+        /**
+         * destructor, unmaps the file
+         */
+        ~MappedGraph ()
+        {
+            ::munmap(_mapping, _size);
+        }
+};
+
+#endif // GraphFile_h
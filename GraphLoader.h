@@ -0,0 +1,325 @@
+// ----------------------------
+// projects/graph/GraphLoader.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ----------------------------
+
+#ifndef GraphLoader_h
+#define GraphLoader_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm> // find, min
+#include <cstddef>   // size_t
+#include <cstdio>    // fopen, fread, fclose
+#include <functional> // ref
+#include <memory>    // unique_ptr
+#include <stdexcept> // runtime_error
+#include <string>    // string
+#include <thread>    // thread
+#include <utility>   // make_pair, pair
+#include <vector>    // vector
+
+#include "Graph.h"
+
+/*
+Text edge lists hold one "u v" edge per line, u and v unsigned decimal integers
+separated by spaces or tabs. Blank lines and lines starting with '#' are skipped.
+A line ending in "\r\n" is accepted.
+*/
+
+// ----------------
+// EdgeListOptions
+// ----------------
+
+struct EdgeListOptions
+{
+    std::size_t block_size;  /*!< bytes read from the file at a time */
+    std::size_t threads;     /*!< parsing threads */
+    std::size_t max_errors;  /*!< malformed lines whose offsets are kept, the rest are only counted */
+
+    EdgeListOptions () : block_size(64 << 20), threads(std::thread::hardware_concurrency()), max_errors(100)
+    {}
+};
+
+// ---------------
+// EdgeListReport
+// ---------------
+
+struct EdgeListReport
+{
+    std::size_t bytes;                 /*!< bytes read */
+    std::size_t lines;                 /*!< edge lines parsed, duplicates included */
+    std::size_t malformed;             /*!< malformed lines */
+    std::vector<std::size_t> offsets;  /*!< byte offsets of the first max_errors malformed lines */
+
+    EdgeListReport () : bytes(0), lines(0), malformed(0), offsets()
+    {}
+};
+
+// ---------------
+// parse_edge_line
+// ---------------
+
+/**
+ * hand-rolled parser for one line, no locale and no allocation
+ * @param b start of the line
+ * @param e end of the line, the '\n' excluded
+ * @param edge receives the edge
+ * @return 1 if an edge was parsed, 0 for a blank or comment line, -1 if the line is malformed
+ */
+inline int parse_edge_line (const char* b, const char* e, std::pair<std::size_t, std::size_t>& edge)
+{
+    if(b != e && e[-1] == '\r')
+    {
+        --e;
+    }
+    while(b != e && (*b == ' ' || *b == '\t'))
+    {
+        ++b;
+    }
+    if(b == e || *b == '#')
+    {
+        return 0;
+    }
+    std::size_t n[2];
+    for(int i = 0; i < 2; ++i)
+    {
+        if(b == e || *b < '0' || *b > '9')
+        {
+            return -1;
+        }
+        std::size_t x = 0;
+        const char* first = b;
+        for(; b != e && *b >= '0' && *b <= '9'; ++b)
+        {
+            x = x * 10 + (*b - '0');
+        }
+        if(b - first > 19) //more digits than a 64 bit vertex_descriptor can hold
+        {
+            return -1;
+        }
+        n[i] = x;
+        const char* blanks = b;
+        while(b != e && (*b == ' ' || *b == '\t'))
+        {
+            ++b;
+        }
+        if(i == 0 && b == blanks)
+        {
+            return -1;
+        }
+    }
+    if(b != e)
+    {
+        return -1;
+    }
+    edge = std::make_pair(n[0], n[1]);
+    return 1;
+}
+
+// ----------------
+// parse_edge_chunk
+// ----------------
+
+/**
+ * parse whole lines
+ * @param b start of the first line
+ * @param e end of the last line
+ * @param base file offset of b
+ * @param max_errors how many malformed offsets to keep
+ * @param edges receives the edges
+ * @param report receives the line counts and the malformed offsets
+ */
+inline void parse_edge_chunk (const char* b, const char* e, std::size_t base, std::size_t max_errors,
+                              std::vector< std::pair<std::size_t, std::size_t> >& edges, EdgeListReport& report)
+{
+    std::pair<std::size_t, std::size_t> edge;
+    while(b != e)
+    {
+        const char* eol = std::find(b, e, '\n');
+        int r = parse_edge_line(b, eol, edge);
+        if(r > 0)
+        {
+            edges.push_back(edge);
+            ++report.lines;
+        }
+        else if(r < 0)
+        {
+            if(report.offsets.size() < max_errors)
+            {
+                report.offsets.push_back(base);
+            }
+            ++report.malformed;
+        }
+        base += (eol - b) + (eol != e);
+        b = eol + (eol != e);
+    }
+}
+
+// ------------
+// ThreadJoiner
+// ------------
+
+/**
+ * joins every thread of a pool when it goes out of scope, so that an exception thrown while
+ * the pool is being started or while the calling thread parses its own slice does not leave
+ * a joinable std::thread to be destroyed, which would call std::terminate
+ */
+struct ThreadJoiner
+{
+    std::vector<std::thread>& pool;
+
+    explicit ThreadJoiner (std::vector<std::thread>& p) : pool(p)
+    {}
+
+    ~ThreadJoiner ()
+    {
+        for(std::size_t t = 0; t < pool.size(); ++t)
+        {
+            if(pool[t].joinable())
+            {
+                pool[t].join();
+            }
+        }
+    }
+};
+
+// --------------
+// read_edge_list
+// --------------
+
+/**
+ * stream a text edge list into a graph
+ * the file is read one block at a time, the block is cut after its last newline (the rest is carried over
+ * to the next block), split in one slice per thread on newline boundaries, the slices are parsed
+ * concurrently into per-thread edge buffers, and the buffers are appended to the edges still to be added
+ * add_edges costs O(V) on top of its edges, so it is only called once at least V edges are pending,
+ * which keeps the whole load O(V + E) however small the blocks are
+ * memory stays around one block plus V + the edges of one block pending, whatever the file size
+ * @param path the file
+ * @param g the graph the edges are added to
+ * @param options block size, threads and error reporting
+ * @return what was read, with the byte offsets of the malformed lines
+ * @throws std::runtime_error if the file can not be read or a line is longer than a block
+ */
+template <typename G>
+EdgeListReport read_edge_list (const std::string& path, G& g, const EdgeListOptions& options = EdgeListOptions())
+{
+    typedef std::vector< std::pair<std::size_t, std::size_t> > edge_buffer;
+
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "rb"), std::fclose); //closed on every way out
+    std::FILE* f = file.get();
+    if(f == 0)
+    {
+        throw std::runtime_error(path + ": can not open");
+    }
+
+    //no need for a block larger than the file
+    std::size_t file_size = options.block_size;
+    if(std::fseek(f, 0, SEEK_END) == 0)
+    {
+        long size = std::ftell(f);
+        file_size = size < 0 ? options.block_size : static_cast<std::size_t>(size);
+        std::rewind(f);
+    }
+
+    const std::size_t threads = std::max<std::size_t>(options.threads, 1);
+    std::vector<char> block(std::max<std::size_t>(std::min(options.block_size, file_size + 1), 2));
+    std::vector<edge_buffer> buffers(threads);
+    std::vector<EdgeListReport> reports(threads);
+    edge_buffer pending; //parsed, not yet added to g
+    EdgeListReport report;
+    std::size_t carried = 0; //bytes of an unfinished line moved to the front of block
+    bool eof = false;
+
+    while(!eof)
+    {
+        std::size_t n = carried + std::fread(block.data() + carried, 1, block.size() - carried, f);
+        eof = n < block.size();
+        if(std::ferror(f))
+        {
+            throw std::runtime_error(path + ": read failed");
+        }
+
+        //only whole lines are parsed, unless this is the last block
+        std::size_t end = n;
+        if(!eof)
+        {
+            const char* last = block.data() + n;
+            while(last != block.data() && last[-1] != '\n')
+            {
+                --last;
+            }
+            if(last == block.data())
+            {
+                throw std::runtime_error(path + ": line longer than the block size at offset " + std::to_string(report.bytes));
+            }
+            end = last - block.data();
+        }
+
+        //cut [0, end) into one slice per thread, each slice ending after a newline
+        std::vector<std::size_t> cuts(1, 0);
+        for(std::size_t t = 1; t < threads; ++t)
+        {
+            std::size_t c = std::max(cuts.back(), end * t / threads);
+            const char* nl = std::find(block.data() + c, block.data() + end, '\n');
+            cuts.push_back(std::min<std::size_t>(nl - block.data() + 1, end));
+        }
+        cuts.push_back(end);
+
+        std::vector<std::thread> pool;
+        ThreadJoiner joiner(pool);
+        for(std::size_t t = 0; t < threads; ++t)
+        {
+            buffers[t].clear();
+            reports[t] = EdgeListReport();
+            const char* b = block.data() + cuts[t];
+            const char* e = block.data() + cuts[t + 1];
+            std::size_t base = report.bytes + cuts[t];
+            if(t + 1 == threads)
+            {
+                parse_edge_chunk(b, e, base, options.max_errors, buffers[t], reports[t]);
+            }
+            else
+            {
+                pool.push_back(std::thread(parse_edge_chunk, b, e, base, options.max_errors, std::ref(buffers[t]), std::ref(reports[t])));
+            }
+        }
+        for(std::size_t t = 0; t < pool.size(); ++t)
+        {
+            pool[t].join();
+        }
+
+        //the slices are in file order, so are the merged offsets
+        for(std::size_t t = 0; t < threads; ++t)
+        {
+            report.lines += reports[t].lines;
+            report.malformed += reports[t].malformed;
+            for(std::size_t i = 0; i < reports[t].offsets.size() && report.offsets.size() < options.max_errors; ++i)
+            {
+                report.offsets.push_back(reports[t].offsets[i]);
+            }
+            pending.insert(pending.end(), buffers[t].begin(), buffers[t].end());
+        }
+        if(pending.size() >= num_vertices(g))
+        {
+            add_edges(g, pending.begin(), pending.end());
+            pending.clear();
+        }
+
+        report.bytes += end;
+        carried = n - end;
+        std::copy(block.data() + end, block.data() + n, block.data());
+    }
+    file.reset();
+    if(!pending.empty())
+    {
+        add_edges(g, pending.begin(), pending.end());
+    }
+    return report;
+}
+
+#endif // GraphLoader_h
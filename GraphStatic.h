@@ -0,0 +1,410 @@
+// ----------------------------
+// projects/graph/GraphStatic.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ----------------------------
+
+#ifndef GraphStatic_h
+#define GraphStatic_h
+
+// --------
+// includes
+// --------
+
+#include <algorithm>        // max
+#include <cstddef>          // size_t
+#include <initializer_list> // initializer_list
+#include <stdexcept>        // length_error
+#include <utility>          // make_pair, pair
+
+#include "Graph.h"
+
+/*
+A StaticGraph holds at most MaxV vertices and MaxE edges in arrays of its own, and everything
+about it is constexpr (C++14), so a dependency table fixed at build time is sorted by the compiler:
+
+    constexpr StaticGraph<4, 8> stages({{0, 1}, {0, 2}, {1, 3}, {2, 3}});
+    static_assert(!has_cycle(stages), "the stages depend on each other");
+    constexpr StaticOrder<4> order = topological_order(stages);   //3 1 2 0, as topological_sort on a Graph
+
+A cycle, or more vertices or edges than the capacity, is a throw, which makes the constant
+expression ill-formed: it fails the build instead of throwing boost::not_a_dag at startup.
+The same functions work at run time too, and give the same results as on a Graph built with the
+same edges: the rows are sorted and the traversal is the one of dfs_postorder.
+add_edge is O(MaxV + MaxE) (the edges are kept as compressed sparse rows, shifted on insertion),
+which is nothing for the tables this is meant for. The operations are not counted by GraphStats.
+*/
+
+// -----------
+// StaticGraph
+// -----------
+
+template <std::size_t MaxV, std::size_t MaxE>
+class StaticGraph
+{
+    static_assert(MaxV > 0 && MaxE > 0, "a StaticGraph needs room for a vertex and an edge");
+
+    public:
+        // --------
+        // typedefs
+        // --------
+
+        typedef std::size_t vertex_descriptor;
+        typedef EdgeDescriptor edge_descriptor;
+
+        typedef const vertex_descriptor* adjacency_iterator;
+
+        typedef std::size_t vertices_size_type;
+        typedef std::size_t edges_size_type;
+
+    public:
+        // --------
+        // add_edge
+        // --------
+
+        /**
+         * add an edge unless it is there, the graph is enlarged to max(v1, v2) + 1 vertices like a Graph
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @param g the graph
+         * @return a pair where first is the edge_descriptor and second whether it was added
+         * @throws std::length_error if v1 or v2 is not below MaxV or if the graph already has MaxE edges
+         */
+        friend constexpr std::pair<edge_descriptor, bool> add_edge (vertex_descriptor v1, vertex_descriptor v2, StaticGraph& g)
+        {
+            edge_descriptor e(v1, v2);
+            if(std::max(v1, v2) >= MaxV)
+            {
+                throw std::length_error("StaticGraph: vertex_descriptor past MaxV");
+            }
+            g._num_vertices = std::max(g._num_vertices, std::max(v1, v2) + 1);
+
+            std::size_t p = g._offsets[v1];
+            while(p != g._offsets[v1 + 1] && g._targets[p] < v2)
+            {
+                ++p;
+            }
+            if(p != g._offsets[v1 + 1] && g._targets[p] == v2)
+            {
+                return std::make_pair(e, false);
+            }
+            if(g._offsets[MaxV] == MaxE)
+            {
+                throw std::length_error("StaticGraph: more than MaxE edges");
+            }
+            for(std::size_t i = g._offsets[MaxV]; i != p; --i)
+            {
+                g._targets[i] = g._targets[i - 1];
+            }
+            g._targets[p] = v2;
+            for(std::size_t u = v1 + 1; u <= MaxV; ++u)
+            {
+                ++g._offsets[u];
+            }
+            return std::make_pair(e, true);
+        }
+
+        // ----------
+        // add_vertex
+        // ----------
+
+        /**
+         * @param g the graph
+         * @return the vertex_descriptor added
+         * @throws std::length_error if the graph already has MaxV vertices
+         */
+        friend constexpr vertex_descriptor add_vertex (StaticGraph& g)
+        {
+            if(g._num_vertices == MaxV)
+            {
+                throw std::length_error("StaticGraph: more than MaxV vertices");
+            }
+            return g._num_vertices++;
+        }
+
+        // -----------------
+        // adjacent_vertices
+        // -----------------
+
+        /**
+         * @param v a vertex_descriptor
+         * @param g the graph
+         * @return the range of v's adjacent vertices, in increasing order
+         */
+        friend constexpr std::pair<adjacency_iterator, adjacency_iterator> adjacent_vertices (vertex_descriptor v, const StaticGraph& g)
+        {
+            return std::make_pair(g._targets + g._offsets[v], g._targets + g._offsets[v + 1]);
+        }
+
+        // ----
+        // edge
+        // ----
+
+        /**
+         * @param v1 a vertex_descriptor
+         * @param v2 a vertex_descriptor
+         * @param g the graph
+         * @return a pair of the edge_descriptor and whether the edge is in the graph, false if v1 is not a vertex
+         */
+        friend constexpr std::pair<edge_descriptor, bool> edge (vertex_descriptor v1, vertex_descriptor v2, const StaticGraph& g)
+        {
+            if(v1 >= num_vertices(g))
+            {
+                return std::make_pair(edge_descriptor(v1, v2), false);
+            }
+            for(std::size_t p = g._offsets[v1]; p != g._offsets[v1 + 1]; ++p)
+            {
+                if(g._targets[p] == v2)
+                {
+                    return std::make_pair(edge_descriptor(v1, v2), true);
+                }
+            }
+            return std::make_pair(edge_descriptor(v1, v2), false);
+        }
+
+        // ---------
+        // num_edges
+        // ---------
+
+        /**
+         * @param g the graph
+         * @return the number of edges
+         */
+        friend constexpr edges_size_type num_edges (const StaticGraph& g)
+        {
+            return g._offsets[MaxV];
+        }
+
+        // ------------
+        // num_vertices
+        // ------------
+
+        /**
+         * @param g the graph
+         * @return the number of vertices
+         */
+        friend constexpr vertices_size_type num_vertices (const StaticGraph& g)
+        {
+            return g._num_vertices;
+        }
+
+        // ------
+        // source
+        // ------
+
+        /**
+         * @param e an edge_descriptor
+         * @return the source of e
+         */
+        friend constexpr vertex_descriptor source (edge_descriptor e, const StaticGraph&)
+        {
+            return e._source;
+        }
+
+        // ------
+        // target
+        // ------
+
+        /**
+         * @param e an edge_descriptor
+         * @return the target of e
+         */
+        friend constexpr vertex_descriptor target (edge_descriptor e, const StaticGraph&)
+        {
+            return e._target;
+        }
+
+        // ------
+        // vertex
+        // ------
+
+        /**
+         * @param nth an index below num_vertices(g)
+         * @return the nth vertex_descriptor, nth itself
+         */
+        friend constexpr vertex_descriptor vertex (vertices_size_type nth, const StaticGraph&)
+        {
+            return nth;
+        }
+
+    private:
+        // ----
+        // data
+        // ----
+
+        vertices_size_type _num_vertices;
+
+        std::size_t _offsets[MaxV + 1]; /*!< v's row is _targets[_offsets[v], _offsets[v + 1]), _offsets[MaxV] is the number of edges */
+
+        vertex_descriptor _targets[MaxE]; /*!< the rows, back to back, each sorted */
+
+    public:
+        // ------------
+        // constructors
+        // ------------
+
+        /**
+         * default constructor, no vertices
+         */
+        constexpr StaticGraph () : _num_vertices(0), _offsets(), _targets()
+        {}
+
+        /**
+         * constructor, the same graph as add_edge called on every pair
+         * @param edges (source, target) pairs
+         * @throws std::length_error as add_edge
+         */
+        constexpr StaticGraph (std::initializer_list< std::pair<vertex_descriptor, vertex_descriptor> > edges) : StaticGraph()
+        {
+            for(const std::pair<vertex_descriptor, vertex_descriptor>* p = edges.begin(); p != edges.end(); ++p)
+            {
+                add_edge(p->first, p->second, *this);
+            }
+        }
+
+        // Default copy, destructor, and copy assignment
+};
+
+// -----------
+// StaticOrder
+// -----------
+
+/**
+ * the vertices of a StaticGraph in some order, a literal type so that it can be a constexpr variable
+ */
+template <std::size_t N>
+struct StaticOrder
+{
+    std::size_t size; /*!< how many of vertices are used */
+    std::size_t vertices[N];
+
+    constexpr std::size_t operator [] (std::size_t i) const
+    {
+        return vertices[i];
+    }
+
+    constexpr const std::size_t* begin () const
+    {
+        return vertices;
+    }
+
+    constexpr const std::size_t* end () const
+    {
+        return vertices + size;
+    }
+};
+
+// -------------
+// dfs_postorder
+// -------------
+
+/**
+ * dfs_postorder on a StaticGraph, constexpr: the same traversal (roots and neighbours in increasing
+ * order, an explicit stack) with the colors and the stack in arrays of MaxV
+ * @param g a StaticGraph
+ * @param x an output iterator that receives the vertices as they turn black
+ * @return true if a back edge was found (the graph is cyclic), the traversal stops there
+ */
+template <std::size_t MaxV, std::size_t MaxE, typename OI>
+constexpr bool dfs_postorder (const StaticGraph<MaxV, MaxE>& g, OI x)
+{
+    typedef typename StaticGraph<MaxV, MaxE>::adjacency_iterator adjacency_iterator;
+    char colors[MaxV] = {}; //0 white, 1 grey, 2 black
+    std::size_t stack[MaxV] = {};
+    adjacency_iterator rest[MaxV] = {}; //the next adjacent vertex of each frame
+    for(std::size_t root = 0; root < num_vertices(g); ++root)
+    {
+        if(colors[root] != 0)
+        {
+            continue;
+        }
+        std::size_t top = 0;
+        colors[root] = 1;
+        stack[top] = root;
+        rest[top++] = adjacent_vertices(root, g).first;
+        while(top != 0)
+        {
+            std::size_t v = stack[top - 1];
+            if(rest[top - 1] != adjacent_vertices(v, g).second)
+            {
+                std::size_t w = *rest[top - 1]++;
+                if(colors[w] == 1)
+                {
+                    return true;
+                }
+                if(colors[w] == 0)
+                {
+                    colors[w] = 1;
+                    stack[top] = w;
+                    rest[top++] = adjacent_vertices(w, g).first;
+                }
+            }
+            else
+            {
+                colors[v] = 2;
+                *x = v;
+                ++x;
+                --top;
+            }
+        }
+    }
+    return false;
+}
+
+// ---------
+// has_cycle
+// ---------
+
+/**
+ * has_cycle on a StaticGraph, constexpr
+ * @param g a StaticGraph
+ * @return bool indicates whether the graph is cyclic
+ */
+template <std::size_t MaxV, std::size_t MaxE>
+constexpr bool has_cycle (const StaticGraph<MaxV, MaxE>& g)
+{
+    std::size_t postorder[MaxV] = {};
+    return dfs_postorder(g, postorder + 0);
+}
+
+// ----------------
+// topological_sort
+// ----------------
+
+/**
+ * topological_sort on a StaticGraph, constexpr, the same output as on a Graph with the same edges
+ * nothing is written to x if the graph is cyclic
+ * @param g a StaticGraph
+ * @param x an output iterator
+ * @throws Boost's not_a_dag exception if has_cycle(), a compile error in a constant expression
+ */
+template <std::size_t MaxV, std::size_t MaxE, typename OI>
+constexpr void topological_sort (const StaticGraph<MaxV, MaxE>& g, OI x)
+{
+    std::size_t postorder[MaxV] = {};
+    if(dfs_postorder(g, postorder + 0))
+    {
+        throw boost::not_a_dag();
+    }
+    for(std::size_t i = 0; i < num_vertices(g); ++i)
+    {
+        *x = postorder[i];
+        ++x;
+    }
+}
+
+/**
+ * topological_sort into a value, for a constexpr variable
+ * @param g a StaticGraph
+ * @return the vertices in the order topological_sort writes them
+ * @throws Boost's not_a_dag exception if has_cycle(), a compile error in a constant expression
+ */
+template <std::size_t MaxV, std::size_t MaxE>
+constexpr StaticOrder<MaxV> topological_order (const StaticGraph<MaxV, MaxE>& g)
+{
+    StaticOrder<MaxV> order = {num_vertices(g), {}};
+    topological_sort(g, order.vertices + 0);
+    return order;
+}
+
+#endif // GraphStatic_h
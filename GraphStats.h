@@ -0,0 +1,518 @@
+// ---------------------------
+// projects/graph/GraphStats.h
+// Copyright (C) 2013
+// Glenn P. Downing
+// ---------------------------
+
+#ifndef GraphStats_h
+#define GraphStats_h
+
+// --------
+// includes
+// --------
+
+#include <atomic>             // atomic
+#include <chrono>             // duration_cast, milliseconds, nanoseconds, steady_clock
+#include <condition_variable> // condition_variable
+#include <cstddef>            // size_t
+#include <cstdint>            // uint64_t
+#include <deque>              // deque
+#include <functional>         // function
+#include <mutex>              // mutex, unique_lock
+#include <ostream>            // ostream
+#include <thread>             // thread
+#include <vector>             // vector
+
+#include "boost/container/small_vector.hpp" // small_vector
+
+/*
+Compiled with -DGRAPH_STATS, every basic_graph counts, per operation, the calls, the time they
+took (also as a histogram of powers of two nanoseconds), the vertices visited, the edges examined
+and the bytes its containers grew by. The algorithms of Graph.h record into the graph they run on;
+the graphs that carry no counters of their own (CsrGraph, CompressedGraph, ...) share one set per
+graph type.
+
+    Graph g;
+    ...
+    GraphStatsSnapshot s = graph_stats(g);                  //a copy, safe to read at leisure
+    std::cout << s;
+    GraphStatsDump dump(g, std::cerr, std::chrono::seconds(10)); //the same, every 10 s until dump is destroyed
+
+Without GRAPH_STATS, GraphStatsScope is an empty class whose member functions do nothing, so the
+calls to it compile away, GRAPH_STATS_BYTES drops the container sizes it wraps unevaluated, basic_graph has no counters, graph_stats returns zeros and GraphStatsDump
+starts no thread. With it, each operation pays two reads of the steady clock and a few relaxed
+atomic additions; see the BenchGraphStats target for what that costs.
+*/
+
+// -------
+// GraphOp
+// -------
+
+enum GraphOp
+{
+    op_add_edge, op_add_edge_acyclic, op_add_edges, op_grow, op_remove_edge, op_clear_vertex, op_remove_vertex, op_compact,
+    op_dfs_postorder, op_has_cycle, op_topological_sort, op_parallel_topological_levels,
+    op_strongly_connected_components, op_parallel_strongly_connected_components, op_reorder, op_count
+};
+
+const char* const graph_op_names[] =
+{
+    "add_edge", "add_edge_acyclic", "add_edges", "grow", "remove_edge", "clear_vertex", "remove_vertex", "compact",
+    "dfs_postorder", "has_cycle", "topological_sort", "parallel_topological_levels",
+    "strongly_connected_components", "parallel_strongly_connected_components", "reorder"
+};
+
+const std::size_t graph_stats_buckets = 48; /*!< latency buckets, the last one gathers everything from 2^47 ns (39 hours) on */
+
+// ------------
+// GraphOpStats
+// ------------
+
+/**
+ * what was recorded for one operation, plain numbers
+ */
+struct GraphOpStats
+{
+    std::uint64_t calls;
+    std::uint64_t nanoseconds; /*!< total over the calls */
+    std::uint64_t vertices_visited;
+    std::uint64_t edges_examined;
+    std::uint64_t bytes_allocated; /*!< growth of the graph's containers, an estimate from their sizes and capacities */
+    std::uint64_t latency[graph_stats_buckets]; /*!< latency[b] counts the calls that took [2^b, 2^(b+1)) ns, latency[0] [0, 2) */
+
+    /**
+     * @param p a fraction, 0.5 for the median
+     * @return an upper bound of the latency of that fraction of the calls, in ns, 0 without calls
+     */
+    std::uint64_t percentile (double p) const
+    {
+        std::uint64_t seen = 0;
+        for(std::size_t b = 0; b < graph_stats_buckets; ++b)
+        {
+            seen += latency[b];
+            if(seen != 0 && seen >= p * calls)
+            {
+                return std::uint64_t(2) << b;
+            }
+        }
+        return 0;
+    }
+};
+
+// ------------------
+// GraphStatsSnapshot
+// ------------------
+
+/**
+ * a copy of the counters of a graph at one point in time
+ */
+struct GraphStatsSnapshot
+{
+    GraphOpStats ops[op_count];
+
+    /**
+     * @param op an operation
+     * @return what was recorded for it
+     */
+    const GraphOpStats& operator [] (GraphOp op) const
+    {
+        return ops[op];
+    }
+
+    /**
+     * one line per operation that was called
+     * @param out a stream
+     * @param s a snapshot
+     * @return out
+     */
+    friend std::ostream& operator << (std::ostream& out, const GraphStatsSnapshot& s)
+    {
+        for(std::size_t op = 0; op < op_count; ++op)
+        {
+            const GraphOpStats& o = s.ops[op];
+            if(o.calls == 0)
+            {
+                continue;
+            }
+            out << graph_op_names[op] << " calls=" << o.calls << " mean_ns=" << o.nanoseconds / o.calls
+                << " p50_ns<=" << o.percentile(0.5) << " p99_ns<=" << o.percentile(0.99) << " max_ns<=" << o.percentile(1.0)
+                << " vertices_visited=" << o.vertices_visited << " edges_examined=" << o.edges_examined
+                << " bytes_allocated=" << o.bytes_allocated << "\n";
+        }
+        return out;
+    }
+};
+
+// ----------
+// GraphStats
+// ----------
+
+/**
+ * the live counters, relaxed atomics so that a dump or a snapshot can read them while the graph is in use
+ * a copy starts from zero, the counters belong to a graph and not to its contents
+ */
+class GraphStats
+{
+    public:
+    /**
+     * default constructor, every counter zero
+     */
+    GraphStats ()
+    {
+        reset();
+    }
+
+    /**
+     * copy constructor, every counter zero
+     */
+    GraphStats (const GraphStats&)
+    {
+        reset();
+    }
+
+    /**
+     * assignment, the counters are left as they are
+     * @return this GraphStats
+     */
+    GraphStats& operator = (const GraphStats&)
+    {
+        return *this;
+    }
+
+    /**
+     * add one call
+     * @param op the operation
+     * @param ns how long it took
+     * @param vertices the vertices it visited
+     * @param edges the edges it examined
+     * @param bytes the bytes the graph grew by
+     */
+    void record (GraphOp op, std::uint64_t ns, std::uint64_t vertices, std::uint64_t edges, std::uint64_t bytes)
+    {
+        Counters& c = _ops[op];
+        c.calls.fetch_add(1, std::memory_order_relaxed);
+        c.nanoseconds.fetch_add(ns, std::memory_order_relaxed);
+        if(vertices != 0)
+        {
+            c.vertices_visited.fetch_add(vertices, std::memory_order_relaxed);
+        }
+        if(edges != 0)
+        {
+            c.edges_examined.fetch_add(edges, std::memory_order_relaxed);
+        }
+        if(bytes != 0)
+        {
+            c.bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        std::size_t b = 0;
+        while(ns > 1 && b + 1 < graph_stats_buckets)
+        {
+            ns >>= 1;
+            ++b;
+        }
+        c.latency[b].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @return a copy of the counters, each one read atomically, the set of them not
+     */
+    GraphStatsSnapshot snapshot () const
+    {
+        GraphStatsSnapshot s;
+        for(std::size_t op = 0; op < op_count; ++op)
+        {
+            const Counters& c = _ops[op];
+            GraphOpStats& o = s.ops[op];
+            o.calls = c.calls.load(std::memory_order_relaxed);
+            o.nanoseconds = c.nanoseconds.load(std::memory_order_relaxed);
+            o.vertices_visited = c.vertices_visited.load(std::memory_order_relaxed);
+            o.edges_examined = c.edges_examined.load(std::memory_order_relaxed);
+            o.bytes_allocated = c.bytes_allocated.load(std::memory_order_relaxed);
+            for(std::size_t b = 0; b < graph_stats_buckets; ++b)
+            {
+                o.latency[b] = c.latency[b].load(std::memory_order_relaxed);
+            }
+        }
+        return s;
+    }
+
+    /**
+     * set every counter back to zero
+     */
+    void reset ()
+    {
+        for(std::size_t op = 0; op < op_count; ++op)
+        {
+            Counters& c = _ops[op];
+            c.calls.store(0, std::memory_order_relaxed);
+            c.nanoseconds.store(0, std::memory_order_relaxed);
+            c.vertices_visited.store(0, std::memory_order_relaxed);
+            c.edges_examined.store(0, std::memory_order_relaxed);
+            c.bytes_allocated.store(0, std::memory_order_relaxed);
+            for(std::size_t b = 0; b < graph_stats_buckets; ++b)
+            {
+                c.latency[b].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    private:
+        struct Counters
+        {
+            std::atomic<std::uint64_t> calls;
+            std::atomic<std::uint64_t> nanoseconds;
+            std::atomic<std::uint64_t> vertices_visited;
+            std::atomic<std::uint64_t> edges_examined;
+            std::atomic<std::uint64_t> bytes_allocated;
+            std::atomic<std::uint64_t> latency[graph_stats_buckets];
+        };
+
+        Counters _ops[op_count];
+};
+
+/**
+ * the counters of the graphs that have none of their own, one set per graph type
+ * basic_graph has its own, found first by argument dependent lookup
+ * @return the counters g records into
+ */
+template <typename G>
+GraphStats& graph_stats_of (const G&)
+{
+    static GraphStats stats;
+    return stats;
+}
+
+// ---------------
+// container_bytes
+// ---------------
+
+/**
+ * @param c a row or a vertex list
+ * @return the heap the container holds, from its capacity
+ */
+template <typename T, typename A>
+std::size_t container_bytes (const std::vector<T, A>& c)
+{
+    return c.capacity() * sizeof(T);
+}
+
+/**
+ * @param c a row or a vertex list
+ * @return the heap the container holds, libstdc++'s 512 byte nodes, one of them even when empty
+ */
+template <typename T, typename A>
+std::size_t container_bytes (const std::deque<T, A>& c)
+{
+    return (c.size() * sizeof(T) / 512 + 1) * 512;
+}
+
+/**
+ * @param c a row or a vertex list
+ * @return the heap the container holds, nothing while it fits inline
+ */
+template <typename T, std::size_t N, typename A, typename O>
+std::size_t container_bytes (const boost::container::small_vector<T, N, A, O>& c)
+{
+    return c.capacity() > N ? c.capacity() * sizeof(T) : 0;
+}
+
+// ---------------
+// GraphStatsScope
+// ---------------
+
+#ifdef GRAPH_STATS
+
+/**
+ * the argument, a container_bytes expression, evaluated only when GRAPH_STATS is defined
+ * the calls are cheap but not free, without GRAPH_STATS not even a function call should be left
+ */
+#define GRAPH_STATS_BYTES(bytes) (bytes)
+
+/**
+ * times one call of an operation and gathers what it did, recorded into the graph's counters when the scope ends
+ */
+class GraphStatsScope
+{
+    public:
+    /**
+     * constructor, starts the clock
+     * @param g the graph the operation works on
+     * @param op the operation
+     */
+    template <typename G>
+    GraphStatsScope (const G& g, GraphOp op) : _stats(graph_stats_of(g)), _op(op), _start(std::chrono::steady_clock::now()), _vertices(0), _edges(0), _bytes(0)
+    {}
+
+    /**
+     * destructor, records the call
+     */
+    ~GraphStatsScope ()
+    {
+        std::chrono::nanoseconds ns = std::chrono::steady_clock::now() - _start;
+        _stats.record(_op, ns.count(), _vertices, _edges, _bytes);
+    }
+
+    /**
+     * @param n vertices the operation visited
+     */
+    void visit_vertices (std::size_t n)
+    {
+        _vertices += n;
+    }
+
+    /**
+     * @param n edges the operation examined
+     */
+    void examine_edges (std::size_t n)
+    {
+        _edges += n;
+    }
+
+    /**
+     * @param before the container_bytes of a container before the operation changed it
+     * @param after its container_bytes after
+     */
+    void allocate (std::size_t before, std::size_t after)
+    {
+        if(after > before)
+        {
+            _bytes += after - before;
+        }
+    }
+
+    private:
+        GraphStats& _stats;
+        GraphOp _op;
+        std::chrono::steady_clock::time_point _start;
+        std::uint64_t _vertices;
+        std::uint64_t _edges;
+        std::uint64_t _bytes;
+
+        GraphStatsScope (const GraphStatsScope&);
+        GraphStatsScope& operator = (const GraphStatsScope&);
+};
+
+#else
+
+#define GRAPH_STATS_BYTES(bytes) std::size_t(0)
+
+/**
+ * GRAPH_STATS is not defined: nothing is timed or counted and every call here compiles away
+ */
+class GraphStatsScope
+{
+    public:
+    template <typename G>
+    GraphStatsScope (const G&, GraphOp)
+    {}
+
+    void visit_vertices (std::size_t)
+    {}
+
+    void examine_edges (std::size_t)
+    {}
+
+    void allocate (std::size_t, std::size_t)
+    {}
+};
+
+#endif
+
+// -----------
+// graph_stats
+// -----------
+
+/**
+ * @param g a graph
+ * @return a copy of the counters g records into, zeros without GRAPH_STATS
+ */
+template <typename G>
+GraphStatsSnapshot graph_stats (const G& g)
+{
+#ifdef GRAPH_STATS
+    return graph_stats_of(g).snapshot();
+#else
+    (void)g;
+    return GraphStatsSnapshot();
+#endif
+}
+
+/**
+ * set the counters g records into back to zero, nothing without GRAPH_STATS
+ * @param g a graph
+ */
+template <typename G>
+void reset_graph_stats (const G& g)
+{
+#ifdef GRAPH_STATS
+    graph_stats_of(g).reset();
+#else
+    (void)g;
+#endif
+}
+
+// --------------
+// GraphStatsDump
+// --------------
+
+/**
+ * writes graph_stats(g) to a stream every period, from a thread of its own, until it is destroyed
+ * the graph and the stream must outlive it, and nobody else may write to the stream meanwhile
+ * without GRAPH_STATS there is nothing to write and no thread is started
+ */
+class GraphStatsDump
+{
+    public:
+    /**
+     * constructor, the first dump is one period from now
+     * @param g a graph
+     * @param out where the snapshots go
+     * @param period time between two dumps
+     */
+    template <typename G>
+    GraphStatsDump (const G& g, std::ostream& out, std::chrono::milliseconds period) : _mutex(), _stop(), _stopped(false), _thread()
+    {
+#ifdef GRAPH_STATS
+        std::function<GraphStatsSnapshot ()> take = [&g] () {return graph_stats(g);};
+        _thread = std::thread([this, take, &out, period] ()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            while(!_stop.wait_for(lock, period, [this] () {return _stopped;}))
+            {
+                out << take() << std::flush;
+            }
+        });
+#else
+        (void)g;
+        (void)out;
+        (void)period;
+#endif
+    }
+
+    /**
+     * destructor, stops the thread without a last dump
+     */
+    ~GraphStatsDump ()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopped = true;
+        }
+        _stop.notify_one();
+        if(_thread.joinable())
+        {
+            _thread.join();
+        }
+    }
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _stop;
+        bool _stopped;
+        std::thread _thread;
+
+        GraphStatsDump (const GraphStatsDump&);
+        GraphStatsDump& operator = (const GraphStatsDump&);
+};
+
+#endif // GraphStats_h
@@ -6,28 +6,69 @@
 
 /*
 To test the program:
-    g++ -pedantic -std=c++0x -Wall Graph.h TestGraph.c++ -o TestGraph -lgtest -lpthread -lgtest_main
+    g++ -pedantic -std=c++14 -Wall Graph.h TestGraph.c++ -o TestGraph -lgtest -lpthread -lgtest_main
 */
 
 // --------
 // includes
 // --------
 
+#include <chrono>   // milliseconds
+#include <cstdio>   // remove
+#include <fstream>  // fstream, ofstream
 #include <iostream> // cout, endl
 #include <iterator> // ostream_iterator
+#include <map>      // map
 #include <sstream>  // ostringstream
+#include <thread>   // thread
 #include <utility>  // pair
 
 #include "boost/graph/adjacency_list.hpp"  // adjacency_list
+#include "boost/graph/strong_components.hpp" // strong_components
 //#include "boost/graph/topological_sort.hpp"// topological_sort use the sort in Graph.h
 
 #include "gtest/gtest.h" //g test
 
 #include "Graph.h"
+#include "GraphArena.h"
+#include "GraphCompressed.h"
+#include "GraphConcurrent.h"
+#include "GraphFile.h"
+#include "GraphLoader.h"
+#include "GraphStatic.h"
+#include "GraphStats.h"
 
 using namespace std;
 using namespace boost;
 
+// --------------
+// same_partition
+// --------------
+
+/**
+ * @param a component numbers, a[v] for each vertex v
+ * @param b component numbers for the same vertices
+ * @return whether two vertices share a component in a exactly when they share one in b
+ */
+bool same_partition (const std::vector<std::size_t>& a, const std::vector<std::size_t>& b)
+{
+    if(a.size() != b.size())
+    {
+        return false;
+    }
+    std::map<std::size_t, std::size_t> a_to_b;
+    std::map<std::size_t, std::size_t> b_to_a;
+    for(std::size_t v = 0; v < a.size(); ++v)
+    {
+        if(a_to_b.insert(std::make_pair(a[v], b[v])).first->second != b[v] ||
+           b_to_a.insert(std::make_pair(b[v], a[v])).first->second != a[v])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 // ---------
 // TestGraph
 // ---------
@@ -114,7 +155,7 @@ class TestGraph : public testing::Test
     }
 };
 
-typedef ::testing::Types< Graph > MyTypes;
+typedef ::testing::Types< Graph, basic_graph<vectorS, vectorS>, basic_graph<small_vectorS<4>, vectorS>, basic_graph<vectorS, vectorS, bidirectionalS>, CsrGraph > MyTypes;
 //typedef ::testing::Types< adjacency_list<setS, vecS, directedS> > MyTypes;
 
 TYPED_TEST_CASE(TestGraph, MyTypes);
@@ -150,6 +191,16 @@ TYPED_TEST_CASE(TestGraph, MyTypes);
         ASSERT_FALSE(p2.second);
     }
 
+    TYPED_TEST(TestGraph, TEST_ADD_EDGE_4) 
+    {
+        //adding an edge to an empty graph enlarges it to max(u, v) + 1 vertices
+        std::pair<typename TestFixture::edge_descriptor, bool> p = add_edge(2, 5, this->empty_g);
+        ASSERT_TRUE(p.second == true);
+        ASSERT_TRUE(num_vertices(this->empty_g) == 6);
+        ASSERT_TRUE(vertex(4, this->empty_g) == 4);
+        ASSERT_TRUE(num_edges(this->empty_g) == 1);
+    }
+
     // ----------------------
     // test_adjacent_vertices
     // ----------------------
@@ -190,7 +241,7 @@ TYPED_TEST_CASE(TestGraph, MyTypes);
         add_edge(v1, v4, this->empty_g);
         add_edge(v1, v5, this->empty_g);
         std::pair<typename TestFixture::adjacency_iterator, typename TestFixture::adjacency_iterator> p = adjacent_vertices(v1, this->empty_g);
-        ASSERT_TRUE(distance(p.first, p.second) == 4);
+        ASSERT_TRUE(std::distance(p.first, p.second) == 4);
 
     }
 
@@ -221,6 +272,18 @@ TYPED_TEST_CASE(TestGraph, MyTypes);
         ASSERT_TRUE(p.second == false);
     }
 
+    TYPED_TEST(TestGraph, TEST_EDGE_4) 
+    {
+        //edges added out of order are all found
+        add_edge(3, 1, this->empty_g);
+        add_edge(3, 0, this->empty_g);
+        add_edge(3, 2, this->empty_g);
+        ASSERT_TRUE(edge(3, 0, this->empty_g).second);
+        ASSERT_TRUE(edge(3, 1, this->empty_g).second);
+        ASSERT_TRUE(edge(3, 2, this->empty_g).second);
+        ASSERT_FALSE(edge(0, 3, this->empty_g).second);
+    }
+
     // ----------
     // test_edges
     // ----------
@@ -263,7 +326,16 @@ TYPED_TEST_CASE(TestGraph, MyTypes);
         add_edge(v1, v4, this->empty_g);
         add_edge(v1, v5, this->empty_g);
         std::pair<typename TestFixture::edge_iterator, typename TestFixture::edge_iterator> p = edges(this->empty_g);
-        ASSERT_TRUE(distance(p.first, p.second) == 4);
+        ASSERT_TRUE(std::distance(p.first, p.second) == 4);
+    }
+
+    TYPED_TEST(TestGraph, TEST_EDGES_4) 
+    {
+        //value-initialized iterators compare equal, as forward iterators must
+        typename TestFixture::edge_iterator b = typename TestFixture::edge_iterator();
+        typename TestFixture::edge_iterator e = typename TestFixture::edge_iterator();
+        ASSERT_TRUE(b == e);
+        ASSERT_FALSE(b != e);
     }
 
     // --------------
@@ -450,7 +522,7 @@ TYPED_TEST_CASE(TestGraph, MyTypes);
         add_vertex(this->empty_g);
         add_vertex(this->empty_g);
         std::pair<typename TestFixture::vertex_iterator, typename TestFixture::vertex_iterator> p = vertices(this->empty_g);
-        ASSERT_TRUE(distance(p.first, p.second) == 4);
+        ASSERT_TRUE(std::distance(p.first, p.second) == 4);
     }
 
     // --------------
@@ -494,6 +566,13 @@ TYPED_TEST_CASE(TestGraph, MyTypes);
     }
     
 
+    TYPED_TEST(TestGraph, TEST_HAS_CYCLE_5) 
+    {
+        //a self loop is a cycle
+        add_edge(3, 3, this->empty_g);
+        ASSERT_TRUE(has_cycle(this->empty_g));
+    }
+
     // ---------------------
     // test_topological_sort
     // ---------------------
@@ -520,3 +599,1754 @@ TYPED_TEST_CASE(TestGraph, MyTypes);
         ASSERT_TRUE(out.str() == "4 3 2 1 0 ");
     }
 
+
+    TYPED_TEST(TestGraph, TEST_TOPOLOGICAL_SORT_3) 
+    {
+        //diamond, the order follows the depth-first finishing order
+        add_edge(0, 1, this->empty_g);
+        add_edge(0, 2, this->empty_g);
+        add_edge(1, 3, this->empty_g);
+        add_edge(2, 3, this->empty_g);
+        std::ostringstream out;
+        topological_sort(this->empty_g, std::ostream_iterator<typename TestFixture::vertex_descriptor>(out, " "));
+        ASSERT_TRUE(out.str() == "3 1 2 0 ");
+    }
+
+    TYPED_TEST(TestGraph, TEST_TOPOLOGICAL_SORT_4) 
+    {
+        //a long chain, deeper than any recursion could go, with its last edge closing a cycle
+        std::size_t n = 100000;
+        for(std::size_t i = 1; i < n; ++i)
+        {
+            add_edge(i - 1, i, this->empty_g);
+        }
+        std::vector<typename TestFixture::vertex_descriptor> order;
+        topological_sort(this->empty_g, std::back_inserter(order));
+        ASSERT_TRUE(order.size() == n);
+        ASSERT_TRUE(order.front() == n - 1);
+        ASSERT_TRUE(order.back() == 0);
+        add_edge(n - 1, 0, this->empty_g);
+        ASSERT_TRUE(has_cycle(this->empty_g));
+    }
+
+    // --------------------------------
+    // test_parallel_topological_levels
+    // --------------------------------
+
+    TYPED_TEST(TestGraph, TEST_PARALLEL_TOPOLOGICAL_LEVELS_1) 
+    {
+        std::vector< std::vector<typename TestFixture::vertex_descriptor> > levels;
+        ASSERT_THROW(parallel_topological_levels(this->g, std::back_inserter(levels), 2), not_a_dag);
+        ASSERT_TRUE(levels.empty());
+    }
+
+    TYPED_TEST(TestGraph, TEST_PARALLEL_TOPOLOGICAL_LEVELS_2) 
+    {
+        //diamond
+        add_edge(0, 1, this->empty_g);
+        add_edge(0, 2, this->empty_g);
+        add_edge(1, 3, this->empty_g);
+        add_edge(2, 3, this->empty_g);
+        std::vector< std::vector<typename TestFixture::vertex_descriptor> > levels;
+        parallel_topological_levels(this->empty_g, std::back_inserter(levels), 2);
+        ASSERT_TRUE(levels.size() == 3);
+        ASSERT_TRUE(levels[0].size() == 1 && levels[0][0] == 3);
+        ASSERT_TRUE(levels[1].size() == 2 && levels[1][0] == 1 && levels[1][1] == 2);
+        ASSERT_TRUE(levels[2].size() == 1 && levels[2][0] == 0);
+    }
+
+    TYPED_TEST(TestGraph, TEST_PARALLEL_TOPOLOGICAL_LEVELS_3) 
+    {
+        //every vertex lands in exactly one level, after all the vertices it points to
+        std::size_t n = 2000;
+        for(std::size_t i = 0; i < 4 * n; ++i)
+        {
+            std::size_t u = (i * 7919) % n;
+            std::size_t v = (i * 104729 + 13) % n;
+            if(u != v)
+            {
+                add_edge(std::min(u, v), std::max(u, v), this->empty_g);
+            }
+        }
+        std::vector< std::vector<typename TestFixture::vertex_descriptor> > levels;
+        parallel_topological_levels(this->empty_g, std::back_inserter(levels), 4);
+        std::vector<std::size_t> level_of(n, levels.size());
+        for(std::size_t l = 0; l < levels.size(); ++l)
+        {
+            for(std::size_t i = 0; i < levels[l].size(); ++i)
+            {
+                ASSERT_TRUE(level_of[levels[l][i]] == levels.size());
+                level_of[levels[l][i]] = l;
+            }
+        }
+        typename TestFixture::edge_iterator b = edges(this->empty_g).first;
+        typename TestFixture::edge_iterator e = edges(this->empty_g).second;
+        for(; b != e; ++b)
+        {
+            ASSERT_TRUE(level_of[target(*b, this->empty_g)] < level_of[source(*b, this->empty_g)]);
+        }
+        ASSERT_TRUE(std::count(level_of.begin(), level_of.end(), levels.size()) == 0);
+    }
+
+    // --------------------
+    // test_has_cycle_witness
+    // --------------------
+
+    TYPED_TEST(TestGraph, TEST_HAS_CYCLE_WITNESS_1) 
+    {
+        std::vector<typename TestFixture::vertex_descriptor> cycle;
+        ASSERT_TRUE(has_cycle(this->g, std::back_inserter(cycle)));
+        ASSERT_TRUE(cycle.size() == 2);
+        ASSERT_TRUE(cycle[0] == this->vdD);
+        ASSERT_TRUE(cycle[1] == this->vdF);
+    }
+
+    TYPED_TEST(TestGraph, TEST_HAS_CYCLE_WITNESS_2) 
+    {
+        //a self loop, then a long cycle hanging off a DAG
+        std::vector<typename TestFixture::vertex_descriptor> cycle;
+        add_edge(0, 1, this->empty_g);
+        add_edge(1, 2, this->empty_g);
+        ASSERT_FALSE(has_cycle(this->empty_g, std::back_inserter(cycle)));
+        ASSERT_TRUE(cycle.empty());
+        add_edge(2, 2, this->empty_g);
+        ASSERT_TRUE(has_cycle(this->empty_g, std::back_inserter(cycle)));
+        ASSERT_TRUE(cycle.size() == 1 && cycle[0] == 2);
+        typename TestFixture::graph_type h;
+        std::size_t n = 1000;
+        for(std::size_t i = 1; i < n; ++i)
+        {
+            add_edge(i - 1, i, h);
+        }
+        add_edge(n - 1, 10, h);
+        cycle.clear();
+        ASSERT_TRUE(has_cycle(h, std::back_inserter(cycle)));
+        ASSERT_TRUE(cycle.size() == n - 10);
+        for(std::size_t i = 0; i < cycle.size(); ++i)
+        {
+            ASSERT_TRUE(edge(cycle[i], cycle[(i + 1) % cycle.size()], h).second);
+        }
+    }
+
+    // -----------------------------------
+    // test_strongly_connected_components
+    // -----------------------------------
+
+    TYPED_TEST(TestGraph, TEST_STRONGLY_CONNECTED_COMPONENTS_1) 
+    {
+        //D and F point to each other, every other vertex is alone, numbered sinks first
+        std::vector<std::size_t> component(num_vertices(this->g));
+        ASSERT_TRUE(strongly_connected_components(this->g, component.begin()) == 7);
+        std::size_t expected[] = {5, 3, 4, 2, 0, 2, 6, 1};
+        ASSERT_TRUE(std::equal(component.begin(), component.end(), expected));
+        std::vector<std::size_t> parallel(num_vertices(this->g));
+        ASSERT_TRUE(parallel_strongly_connected_components(this->g, parallel.begin(), 2) == 7);
+        ASSERT_TRUE(same_partition(component, parallel));
+        ASSERT_TRUE(strongly_connected_components(this->empty_g, component.begin()) == 0);
+        ASSERT_TRUE(parallel_strongly_connected_components(this->empty_g, parallel.begin(), 2) == 0);
+    }
+
+    TYPED_TEST(TestGraph, TEST_STRONGLY_CONNECTED_COMPONENTS_2) 
+    {
+        //random edges, many of them backwards, with any number of threads
+        std::size_t n = 2000;
+        std::size_t seed = 7;
+        for(std::size_t i = 0; i < 3 * n; ++i)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            std::size_t u = (seed >> 33) % n;
+            std::size_t v = (seed >> 13) % n;
+            if(i % 5 == 0)
+            {
+                add_edge(std::max(u, v), std::min(u, v), this->empty_g);
+            }
+            else
+            {
+                add_edge(std::min(u, v), std::max(u, v), this->empty_g);
+            }
+        }
+        std::vector<std::size_t> component(num_vertices(this->empty_g));
+        std::size_t count = strongly_connected_components(this->empty_g, component.begin());
+        ASSERT_TRUE(count > 1 && count < num_vertices(this->empty_g));
+        typename TestFixture::edge_iterator b = edges(this->empty_g).first;
+        typename TestFixture::edge_iterator e = edges(this->empty_g).second;
+        for(; b != e; ++b)
+        {
+            ASSERT_TRUE(component[source(*b, this->empty_g)] >= component[target(*b, this->empty_g)]);
+        }
+        for(std::size_t threads = 1; threads <= 4; ++threads)
+        {
+            std::vector<std::size_t> parallel(num_vertices(this->empty_g));
+            ASSERT_TRUE(parallel_strongly_connected_components(this->empty_g, parallel.begin(), threads) == count);
+            ASSERT_TRUE(same_partition(component, parallel));
+        }
+    }
+
+    // ------------
+    // test_reorder
+    // ------------
+
+    TYPED_TEST(TestGraph, TEST_REORDER_1) 
+    {
+        //every strategy is a bijection and carries every edge over, and nothing else
+        ReorderStrategy strategies[] = {reorder_bfs, reorder_rcm, reorder_degree};
+        for(std::size_t k = 0; k < 3; ++k)
+        {
+            Reordering<typename TestFixture::graph_type> r = reorder(this->g, strategies[k]);
+            ASSERT_TRUE(num_vertices(r.graph) == 8);
+            ASSERT_TRUE(num_edges(r.graph) == 11);
+            ASSERT_TRUE(r.permutation.size() == 8);
+            ASSERT_TRUE(r.inverse.size() == 8);
+            for(std::size_t v = 0; v < 8; ++v)
+            {
+                ASSERT_TRUE(r.inverse[r.permutation[v]] == v);
+            }
+            typename TestFixture::edge_iterator b = edges(this->g).first;
+            typename TestFixture::edge_iterator e = edges(this->g).second;
+            for(; b != e; ++b)
+            {
+                ASSERT_TRUE(edge(r.permutation[source(*b, this->g)], r.permutation[target(*b, this->g)], r.graph).second);
+            }
+        }
+        //D has four neighbours, B, C, E and F, more than any other vertex
+        ASSERT_TRUE(reorder(this->g, reorder_degree).inverse[0] == this->vdD);
+    }
+
+    TYPED_TEST(TestGraph, TEST_REORDER_2) 
+    {
+        //a path whose labels are scrambled comes out with every edge between neighbouring labels
+        std::size_t n = 200;
+        for(std::size_t i = 0; i + 1 < n; ++i)
+        {
+            add_edge(i * 73 % n, (i + 1) * 73 % n, this->empty_g);
+        }
+        ReorderStrategy strategies[] = {reorder_bfs, reorder_rcm};
+        for(std::size_t k = 0; k < 2; ++k)
+        {
+            Reordering<typename TestFixture::graph_type> r = reorder(this->empty_g, strategies[k]);
+            typename TestFixture::edge_iterator b = edges(r.graph).first;
+            typename TestFixture::edge_iterator e = edges(r.graph).second;
+            for(; b != e; ++b)
+            {
+                std::size_t u = source(*b, r.graph);
+                std::size_t v = target(*b, r.graph);
+                ASSERT_TRUE(std::max(u, v) - std::min(u, v) == 1);
+            }
+            //a topological order of the copy, translated back, is one of the original
+            std::vector<std::size_t> order;
+            topological_sort(r.graph, std::back_inserter(order));
+            ASSERT_TRUE(order.size() == n);
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                ASSERT_TRUE(r.inverse[order[i]] == (n - 1 - i) * 73 % n);
+            }
+        }
+    }
+
+// ----------------
+// TestEdgeIterator
+// ----------------
+
+//one graph type per edge_iterator class, read-only types included, built from the same Graph
+template <typename T>
+class TestEdgeIterator : public testing::Test
+{
+    public:
+    typedef T                                  graph_type;
+    typedef typename graph_type::edge_iterator edge_iterator;
+
+    Graph source;
+
+    virtual void SetUp()
+    {
+        add_edge(0, 1, source);
+        add_edge(0, 2, source);
+        add_edge(3, 1, source);
+        add_vertex(source);
+    }
+};
+
+typedef ::testing::Types< Graph, CsrGraph, CompressedGraph, GraphSnapshot > EdgeIteratorTypes;
+
+TYPED_TEST_CASE(TestEdgeIterator, EdgeIteratorTypes);
+
+    TYPED_TEST(TestEdgeIterator, TEST_EDGES_1) 
+    {
+        typename TestFixture::graph_type g(this->source);
+        std::pair<typename TestFixture::edge_iterator, typename TestFixture::edge_iterator> p = edges(g);
+        ASSERT_TRUE(std::distance(p.first, p.second) == 3);
+        ASSERT_TRUE(std::equal(p.first, p.second, edges(this->source).first));
+        typename TestFixture::edge_iterator b = p.first;
+        ASSERT_TRUE(b++ == p.first);
+        ASSERT_TRUE(*b == EdgeDescriptor(0, 2));
+    }
+
+    TYPED_TEST(TestEdgeIterator, TEST_EDGES_2) 
+    {
+        //no edges, and no vertices at all
+        Graph vertices_only;
+        add_vertex(vertices_only);
+        add_vertex(vertices_only);
+        typename TestFixture::graph_type g(vertices_only);
+        ASSERT_TRUE(edges(g).first == edges(g).second);
+        typename TestFixture::graph_type empty;
+        ASSERT_TRUE(edges(empty).first == edges(empty).second);
+    }
+
+    TYPED_TEST(TestEdgeIterator, TEST_EDGES_3) 
+    {
+        //value-initialized iterators compare equal, as forward iterators must
+        typename TestFixture::edge_iterator b = typename TestFixture::edge_iterator();
+        typename TestFixture::edge_iterator e = typename TestFixture::edge_iterator();
+        ASSERT_TRUE(b == e);
+        ASSERT_FALSE(b != e);
+    }
+
+// ------------------
+// TestGraphAddEdges
+// ------------------
+
+TEST(TestGraphAddEdges, TEST_CONSTRUCTOR_1) 
+{
+    //unsorted, with duplicates, same graph as add_edge one at a time
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    Graph g;
+    for(std::size_t i = 0; i < 500; ++i)
+    {
+        el.push_back(std::make_pair((i * 37) % 101, (i * 53) % 97));
+        add_edge((i * 37) % 101, (i * 53) % 97, g);
+    }
+    Graph bulk(el.begin(), el.end());
+    ASSERT_TRUE(bulk == g);
+    ASSERT_TRUE(num_edges(bulk) == num_edges(g));
+    ASSERT_TRUE(num_vertices(bulk) == 101);
+}
+
+TEST(TestGraphAddEdges, TEST_CONSTRUCTOR_2) 
+{
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    el.push_back(std::make_pair(1, 2));
+    Graph g(el.begin(), el.end(), 5);
+    ASSERT_TRUE(num_vertices(g) == 5);
+    ASSERT_TRUE(vertex(4, g) == 4);
+    ASSERT_TRUE(num_edges(g) == 1);
+    Graph empty(el.end(), el.end());
+    ASSERT_TRUE(empty == Graph());
+}
+
+TEST(TestGraphAddEdges, TEST_ADD_EDGES_1) 
+{
+    //merged into rows that already have edges
+    Graph g;
+    add_edge(0, 1, g);
+    add_edge(0, 4, g);
+    add_edge(2, 0, g);
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    el.push_back(std::make_pair(0, 3));
+    el.push_back(std::make_pair(0, 4));
+    el.push_back(std::make_pair(6, 0));
+    el.push_back(std::make_pair(0, 0));
+    ASSERT_TRUE(add_edges(g, el.begin(), el.end()) == 3);
+    ASSERT_TRUE(num_edges(g) == 6);
+    ASSERT_TRUE(num_vertices(g) == 7);
+    std::pair<Graph::adjacency_iterator, Graph::adjacency_iterator> p = adjacent_vertices(0, g);
+    std::vector<std::size_t> row(p.first, p.second);
+    ASSERT_TRUE(row.size() == 4);
+    ASSERT_TRUE(row[0] == 0 && row[1] == 1 && row[2] == 3 && row[3] == 4);
+}
+
+// --------------
+// TestGraphArena
+// --------------
+
+template <typename G>
+void build_arena_graph (G& g)
+{
+    add_vertex(g);
+    for(std::size_t i = 0; i < 300; ++i)
+    {
+        add_edge((i * 37) % 101, (i * 53) % 97, g);
+    }
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    el.push_back(std::make_pair(150, 3));
+    el.push_back(std::make_pair(3, 150));
+    add_edges(g, el.begin(), el.end());
+}
+
+TEST(TestGraphArena, TEST_ARENA_1) 
+{
+    //every storage selector allocates from the arena and behaves like Graph
+    Graph expected;
+    build_arena_graph(expected);
+    MonotonicArena arena(256);
+    ArenaAllocator<std::size_t> a(arena);
+    basic_graph<dequeS, dequeS, boost::directedS, ArenaAllocator<std::size_t> > g1(a);
+    basic_graph<vectorS, vectorS, boost::directedS, ArenaAllocator<std::size_t> > g2(a);
+    basic_graph<small_vectorS<4>, vectorS, boost::directedS, ArenaAllocator<std::size_t> > g3(a);
+    build_arena_graph(g1);
+    std::size_t used = arena.bytes_allocated();
+    ASSERT_TRUE(used > 0);
+    build_arena_graph(g2);
+    ASSERT_TRUE(arena.bytes_allocated() > used);
+    build_arena_graph(g3);
+    ASSERT_TRUE(CsrGraph(g1) == CsrGraph(expected));
+    ASSERT_TRUE(CsrGraph(g2) == CsrGraph(expected));
+    ASSERT_TRUE(CsrGraph(g3) == CsrGraph(expected));
+    ASSERT_TRUE(has_cycle(g3));
+}
+
+TEST(TestGraphArena, TEST_ARENA_2) 
+{
+    //copies and bulk built graphs stay on the arena they were given
+    MonotonicArena arena;
+    ArenaAllocator<std::size_t> a(arena);
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    el.push_back(std::make_pair(0, 1));
+    el.push_back(std::make_pair(1, 2));
+    basic_graph<vectorS, vectorS, boost::directedS, ArenaAllocator<std::size_t> > g(el.begin(), el.end(), 0, a);
+    basic_graph<vectorS, vectorS, boost::directedS, ArenaAllocator<std::size_t> > h(g);
+    ASSERT_TRUE(h == g);
+    ASSERT_TRUE(h.get_allocator().arena() == &arena);
+    std::size_t used = arena.bytes_allocated();
+    add_edge(2, 7, h);
+    ASSERT_TRUE(arena.bytes_allocated() > used);
+    ASSERT_TRUE(num_vertices(h) == 8);
+    ASSERT_FALSE(h == g);
+}
+
+TEST(TestGraphArena, TEST_ARENA_3) 
+{
+    MonotonicArena arena(16);
+    void* p = arena.allocate(8, 8);
+    void* q = arena.allocate(100, 16);
+    ASSERT_TRUE(reinterpret_cast<std::size_t>(q) % 16 == 0);
+    ASSERT_TRUE(p != q);
+    ASSERT_TRUE(arena.bytes_allocated() == 108);
+    arena.release();
+    ASSERT_TRUE(arena.bytes_allocated() == 0);
+}
+
+// ----------------
+// TestGraphAcyclic
+// ----------------
+
+//whether order, sinks first as topological_sort writes it, puts every target before its source
+template <typename G>
+bool is_topological (const G& g, const std::vector<std::size_t>& order)
+{
+    std::vector<std::size_t> position(num_vertices(g), order.size());
+    for(std::size_t i = 0; i < order.size(); ++i)
+    {
+        position[order[i]] = i;
+    }
+    typename G::edge_iterator b, e;
+    for(boost::tie(b, e) = edges(g); b != e; ++b)
+    {
+        if(position[source(*b, g)] <= position[target(*b, g)] || position[source(*b, g)] == order.size())
+        {
+            return false;
+        }
+    }
+    return order.size() == num_vertices(g);
+}
+
+TEST(TestGraphAcyclic, TEST_ACYCLIC_1) 
+{
+    //every edge goes against the order kept so far
+    Graph g;
+    ASSERT_TRUE(add_edge_acyclic(1, 0, g).second);
+    ASSERT_TRUE(add_edge_acyclic(2, 1, g).second);
+    ostringstream out;
+    topological_sort(g, std::ostream_iterator<std::size_t>(out, " "));
+    ASSERT_TRUE(out.str() == "0 1 2 ");
+    ASSERT_THROW(add_edge_acyclic(0, 2, g), not_a_dag);
+    ASSERT_THROW(add_edge_acyclic(1, 1, g), not_a_dag);
+    ASSERT_TRUE(num_edges(g) == 2);
+    ASSERT_FALSE(edge(0, 2, g).second);
+    ASSERT_FALSE(add_edge_acyclic(2, 1, g).second);
+    ASSERT_TRUE(add_edge_acyclic(2, 0, g).second);
+    ASSERT_TRUE(num_edges(g) == 3);
+}
+
+TEST(TestGraphAcyclic, TEST_ACYCLIC_2) 
+{
+    //a graph that already has a cycle is refused, one built with add_edge gets its order computed once
+    Graph g;
+    add_edge(0, 1, g);
+    add_edge(1, 0, g);
+    ASSERT_THROW(add_edge_acyclic(1, 2, g), not_a_dag);
+    ASSERT_TRUE(num_vertices(g) == 2);
+
+    Graph h;
+    add_edge(3, 2, h);
+    add_edge(2, 1, h);
+    ASSERT_TRUE(add_edge_acyclic(1, 0, h).second);
+    ASSERT_THROW(add_edge_acyclic(0, 3, h), not_a_dag);
+    add_edge(4, 5, h);
+    add_edge(5, 4, h); //contradicts the kept order, topological_sort goes back to the traversal
+    ASSERT_THROW(topological_sort(h, discard_iterator()), not_a_dag);
+}
+
+template <typename G>
+void check_acyclic_stream ()
+{
+    //same answers as adding the edge and running has_cycle on the whole graph
+    G g;
+    G reference;
+    std::size_t seed = 7;
+    for(std::size_t i = 0; i < 400; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::size_t u = (seed >> 33) % 40;
+        std::size_t v = (seed >> 13) % 40;
+        G attempt(reference);
+        bool added = add_edge(u, v, attempt).second;
+        bool acyclic = !has_cycle(attempt);
+        if(acyclic)
+        {
+            ASSERT_TRUE(add_edge_acyclic(u, v, g).second == added);
+            reference = attempt;
+        }
+        else
+        {
+            ASSERT_THROW(add_edge_acyclic(u, v, g), not_a_dag);
+        }
+        ASSERT_TRUE(num_edges(g) == num_edges(reference));
+    }
+    std::vector<std::size_t> order;
+    topological_sort(g, std::back_inserter(order));
+    ASSERT_TRUE(is_topological(g, order));
+    ASSERT_TRUE(CsrGraph(g) == CsrGraph(reference));
+}
+
+TEST(TestGraphAcyclic, TEST_ACYCLIC_3) 
+{
+    check_acyclic_stream<Graph>();
+    check_acyclic_stream< basic_graph<vectorS, vectorS> >();
+    check_acyclic_stream< basic_graph<small_vectorS<4>, vectorS> >();
+}
+
+TEST(TestGraphAcyclic, TEST_ACYCLIC_4) 
+{
+    //add_vertex, in order add_edge and add_edges keep the order
+    Graph g;
+    add_edge_acyclic(0, 1, g);
+    add_vertex(g);
+    add_edge(1, 2, g);
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    el.push_back(std::make_pair(2, 3));
+    add_edges(g, el.begin(), el.end());
+    ostringstream out;
+    topological_sort(g, std::ostream_iterator<std::size_t>(out, " "));
+    ASSERT_TRUE(out.str() == "3 2 1 0 ");
+    ASSERT_THROW(add_edge_acyclic(3, 0, g), not_a_dag);
+    std::vector<std::size_t> order;
+    topological_sort(g, std::back_inserter(order));
+    ASSERT_TRUE(is_topological(g, order));
+}
+
+TEST(TestGraphAcyclic, TEST_ACYCLIC_5) 
+{
+    //a self loop added with add_edge or add_edges drops the kept order
+    Graph g;
+    add_edge_acyclic(0, 1, g);
+    add_edge_acyclic(1, 2, g);
+    add_edge(2, 2, g);
+    ASSERT_THROW(topological_sort(g, discard_iterator()), not_a_dag);
+    ASSERT_THROW(add_edge_acyclic(2, 3, g), not_a_dag);
+
+    Graph h;
+    add_edge_acyclic(0, 1, h);
+    add_edge_acyclic(1, 2, h);
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    el.push_back(std::make_pair(2, 2));
+    add_edges(h, el.begin(), el.end());
+    ASSERT_THROW(topological_sort(h, discard_iterator()), not_a_dag);
+    ASSERT_THROW(add_edge_acyclic(2, 3, h), not_a_dag);
+}
+
+// ----------------------
+// TestGraphBidirectional
+// ----------------------
+
+TEST(TestGraphBidirectional, TEST_BIDIRECTIONAL_1) 
+{
+    basic_graph<dequeS, dequeS, bidirectionalS> g;
+    add_edge(2, 1, g);
+    add_edge(0, 1, g);
+    add_edge(0, 1, g);
+    add_edge(1, 3, g);
+    ASSERT_TRUE(in_degree(1, g) == 2);
+    ASSERT_TRUE(in_degree(0, g) == 0);
+    ASSERT_TRUE(in_degree(3, g) == 1);
+    ostringstream out;
+    std::copy(inv_adjacent_vertices(1, g).first, inv_adjacent_vertices(1, g).second, std::ostream_iterator<std::size_t>(out, " "));
+    ASSERT_TRUE(out.str() == "0 2 ");
+    basic_graph<dequeS, dequeS, bidirectionalS>::in_edge_iterator b, e;
+    boost::tie(b, e) = in_edges(1, g);
+    ASSERT_TRUE(std::distance(b, e) == 2);
+    ASSERT_TRUE(*b == EdgeDescriptor(0, 1));
+    ASSERT_TRUE(source(*b, g) == 0);
+    ASSERT_TRUE(target(*b, g) == 1);
+    ASSERT_TRUE(*++b == EdgeDescriptor(2, 1));
+}
+
+template <typename G>
+void check_in_edges (const G& g)
+{
+    //same in-neighbours as a scan of every edge
+    std::vector< std::vector<std::size_t> > expected(vertex_index_bound(g));
+    typename G::edge_iterator b, e;
+    for(boost::tie(b, e) = edges(g); b != e; ++b)
+    {
+        expected[target(*b, g)].push_back(source(*b, g));
+    }
+    for(std::size_t v = 0; v < vertex_index_bound(g); ++v)
+    {
+        std::sort(expected[v].begin(), expected[v].end());
+        ASSERT_TRUE(in_degree(v, g) == expected[v].size());
+        ASSERT_TRUE(std::equal(expected[v].begin(), expected[v].end(), inv_adjacent_vertices(v, g).first));
+        typename G::in_edge_iterator ib, ie;
+        std::size_t i = 0;
+        for(boost::tie(ib, ie) = in_edges(v, g); ib != ie; ++ib, ++i)
+        {
+            ASSERT_TRUE(*ib == EdgeDescriptor(expected[v][i], v));
+        }
+    }
+}
+
+TEST(TestGraphBidirectional, TEST_BIDIRECTIONAL_2) 
+{
+    //add_edge, add_edges on a graph that has edges already, the bulk constructor and add_edge_acyclic keep the in-neighbours
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    std::size_t seed = 11;
+    for(std::size_t i = 0; i < 300; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        el.push_back(std::make_pair((seed >> 33) % 60, (seed >> 13) % 60));
+    }
+    basic_graph<small_vectorS<4>, vectorS, bidirectionalS> g;
+    for(std::size_t i = 0; i < 150; ++i)
+    {
+        add_edge(el[i].first, el[i].second, g);
+    }
+    add_edges(g, el.begin() + 100, el.end());
+    check_in_edges(g);
+
+    basic_graph<vectorS, vectorS, bidirectionalS> h(el.begin(), el.end());
+    check_in_edges(h);
+    ASSERT_TRUE(CsrGraph(h) == CsrGraph(g));
+
+    basic_graph<vectorS, vectorS, bidirectionalS> d;
+    for(std::size_t i = 0; i < el.size(); ++i)
+    {
+        if(el[i].first < el[i].second)
+        {
+            add_edge_acyclic(el[i].second, el[i].first, d);
+        }
+    }
+    check_in_edges(d);
+}
+
+// ---------------
+// TestGraphRemove
+// ---------------
+
+TEST(TestGraphRemove, TEST_REMOVE_EDGE_1) 
+{
+    basic_graph<vectorS, vectorS, bidirectionalS> g;
+    add_edge(0, 1, g);
+    add_edge(0, 2, g);
+    add_edge(2, 1, g);
+    remove_edge(0, 1, g);
+    remove_edge(0, 1, g);
+    remove_edge(1, 0, g);
+    remove_edge(7, 0, g);
+    ASSERT_TRUE(num_edges(g) == 2);
+    ASSERT_FALSE(edge(0, 1, g).second);
+    ASSERT_TRUE(edge(0, 2, g).second);
+    ASSERT_TRUE(in_degree(1, g) == 1);
+    ASSERT_TRUE(*inv_adjacent_vertices(1, g).first == 2);
+    remove_edge(EdgeDescriptor(2, 1), g);
+    ASSERT_TRUE(num_edges(g) == 1);
+    ASSERT_TRUE(in_degree(1, g) == 0);
+    ASSERT_TRUE(num_vertices(g) == 3);
+    check_in_edges(g);
+}
+
+TEST(TestGraphRemove, TEST_REMOVE_VERTEX_1) 
+{
+    //the other vertex_descriptors stay, the traversals skip the removed vertex
+    Graph g;
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+    add_edge(2, 0, g);
+    add_edge(2, 3, g);
+    add_edge(3, 3, g);
+    remove_vertex(3, g);
+    remove_vertex(3, g);
+    ASSERT_TRUE(num_vertices(g) == 3);
+    ASSERT_TRUE(vertex_index_bound(g) == 4);
+    ASSERT_TRUE(num_edges(g) == 3);
+    ASSERT_TRUE(has_cycle(g));
+    remove_vertex(1, g);
+    ASSERT_TRUE(num_vertices(g) == 2);
+    ASSERT_TRUE(num_edges(g) == 1);
+    ASSERT_TRUE(vertex(1, g) == Graph::null_vertex());
+    ostringstream out;
+    std::copy(vertices(g).first, vertices(g).second, std::ostream_iterator<std::size_t>(out, " "));
+    ASSERT_TRUE(out.str() == "0 2 ");
+    ASSERT_FALSE(has_cycle(g));
+    std::vector<std::size_t> order;
+    topological_sort(g, std::back_inserter(order));
+    ASSERT_TRUE(order.size() == 2 && order[0] == 0 && order[1] == 2);
+    std::vector< std::vector<std::size_t> > levels;
+    parallel_topological_levels(g, std::back_inserter(levels), 2);
+    ASSERT_TRUE(levels.size() == 2);
+    std::vector<std::size_t> component(vertex_index_bound(g), 9);
+    ASSERT_TRUE(strongly_connected_components(g, component.begin()) == 2);
+    ASSERT_TRUE(component[1] == 9 && component[3] == 9);
+    ASSERT_TRUE(parallel_strongly_connected_components(g, component.begin(), 2) == 2);
+    ASSERT_TRUE(component[1] == 9 && component[3] == 9);
+    add_edge(3, 0, g); //brings 3 back, without its old edges
+    ASSERT_TRUE(num_vertices(g) == 3);
+    ASSERT_TRUE(num_edges(g) == 2);
+    ASSERT_FALSE(edge(3, 3, g).second);
+}
+
+TEST(TestGraphRemove, TEST_REMOVE_VERTEX_2) 
+{
+    //a kept order survives removals and compaction
+    basic_graph<vectorS, vectorS, bidirectionalS> g;
+    for(std::size_t i = 1; i < 10; ++i)
+    {
+        add_edge_acyclic(i, i - 1, g);
+    }
+    remove_vertex(4, g);
+    remove_edge(8, 7, g);
+    check_in_edges(g);
+    add_edge_acyclic(0, 9, g);
+    ASSERT_THROW(add_edge_acyclic(8, 0, g), not_a_dag);
+    std::vector<std::size_t> order;
+    topological_sort(g, std::back_inserter(order));
+    ASSERT_TRUE(order.size() == 9);
+    ASSERT_TRUE(std::find(order.begin(), order.end(), 4) == order.end());
+    std::vector<std::size_t> remap = compact(g);
+    ASSERT_TRUE(remap.size() == 10);
+    ASSERT_TRUE(remap[3] == 3 && remap[4] == Graph::null_vertex() && remap[5] == 4 && remap[9] == 8);
+    ASSERT_TRUE(num_vertices(g) == 9);
+    ASSERT_TRUE(vertex_index_bound(g) == 9);
+    ASSERT_TRUE(num_edges(g) == 7);
+    ASSERT_TRUE(edge(5, 4, g).second && !edge(4, 3, g).second && edge(0, 8, g).second && !edge(7, 6, g).second);
+    check_in_edges(g);
+    std::vector<std::size_t> compacted;
+    topological_sort(g, std::back_inserter(compacted));
+    for(std::size_t i = 0; i < order.size(); ++i)
+    {
+        ASSERT_TRUE(compacted[i] == remap[order[i]]);
+    }
+    ASSERT_THROW(add_edge_acyclic(7, 0, g), not_a_dag);
+}
+
+template <typename G>
+void check_tombstones ()
+{
+    //the edges into a cleared vertex stay in their rows as tombstones, new ones to it and add_edges replace them
+    G g;
+    G expected;
+    for(std::size_t u = 0; u < 6; ++u)
+    {
+        add_edge(u, 6, g);
+        add_edge(6, u, g);
+    }
+    add_edge(6, 6, g);
+    remove_edge(2, 6, g);
+    clear_vertex(6, g);
+    ASSERT_TRUE(num_edges(g) == 0);
+    ASSERT_TRUE(edges(g).first == edges(g).second);
+    ASSERT_FALSE(edge(0, 6, g).second);
+    add_edge(0, 6, g);
+    add_edge(0, 6, expected);
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    el.push_back(std::make_pair(2, 6));
+    el.push_back(std::make_pair(6, 3));
+    add_edges(g, el.begin(), el.end());
+    add_edges(expected, el.begin(), el.end());
+    ASSERT_TRUE(num_edges(g) == 3);
+    ASSERT_TRUE(g == expected);
+    ASSERT_TRUE(std::equal(edges(g).first, edges(g).second, edges(expected).first));
+    ASSERT_TRUE(std::distance(adjacent_vertices(1, g).first, adjacent_vertices(1, g).second) == 0);
+
+    //more removed edges than edges and vertices are reclaimed on the way, on a small graph soon
+    //and on a large one only once a vertex is cleared more times than a generation can count
+    clear_vertex(6, g);
+    add_edge(0, 1, g);
+    add_edge(2, 3, g);
+    add_edge(4, 5, g);
+    for(std::size_t n = 7; n <= 100000; n += 99993)
+    {
+        while(vertex_index_bound(g) < n)
+        {
+            add_vertex(g);
+        }
+        for(std::size_t i = 0; i < 33000; ++i)
+        {
+            add_edge(1, 6, g);
+            add_edge(6, 1, g);
+            remove_edge(6, 1, g);
+            clear_vertex(6, g);
+        }
+        ASSERT_TRUE(num_edges(g) == 3);
+        add_edge(1, 6, g);
+        add_edge(6, 1, g);
+        ASSERT_TRUE(num_edges(g) == 5);
+        ASSERT_TRUE(edge(1, 6, g).second && edge(6, 1, g).second && !edge(0, 6, g).second && edge(0, 1, g).second);
+        ASSERT_TRUE(std::distance(edges(g).first, edges(g).second) == 5);
+        clear_vertex(6, g);
+    }
+    ASSERT_TRUE(compact(g).size() == 100000);
+    ASSERT_TRUE(num_edges(g) == 3);
+    ASSERT_TRUE(std::distance(edges(g).first, edges(g).second) == 3);
+}
+
+TEST(TestGraphRemove, TEST_TOMBSTONES_1) 
+{
+    check_tombstones<Graph>();
+    check_tombstones< basic_graph<small_vectorS<4>, vectorS> >();
+    check_tombstones< basic_graph<vectorS, vectorS, bidirectionalS> >();
+}
+
+TEST(TestGraphRemove, TEST_TOMBSTONES_2) 
+{
+    //in-neighbours skip the tombstones as the rows do
+    basic_graph<vectorS, vectorS, bidirectionalS> g;
+    add_edge(0, 2, g);
+    add_edge(1, 2, g);
+    add_edge(2, 3, g);
+    clear_vertex(0, g);
+    ASSERT_TRUE(in_degree(2, g) == 1);
+    ASSERT_TRUE(*inv_adjacent_vertices(2, g).first == 1);
+    remove_edge(1, 2, g);
+    add_edge(0, 2, g);
+    ASSERT_TRUE(in_degree(2, g) == 1);
+    ASSERT_TRUE(*in_edges(2, g).first == EdgeDescriptor(0, 2));
+    check_in_edges(g);
+}
+
+template <typename G>
+void check_mixed_removals ()
+{
+    //the same inserts and removals as boost, whose vecS vertex list renumbers at every remove_vertex like compact does at the end
+    //vecS rows, boost's remove_vertex renumbers setS rows in place and breaks them
+    typedef adjacency_list<vecS, vecS, directedS> boost_graph;
+    G g;
+    boost_graph b;
+    std::vector<std::size_t> ids; //boost's vertex_descriptor of each vertex of g, null_vertex() once removed
+    std::size_t seed = 5;
+    for(std::size_t i = 0; i < 3000; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::size_t u = (seed >> 33) % (ids.size() + 1);
+        std::size_t v = (seed >> 13) % (ids.size() + 1);
+        std::size_t op = (seed >> 50) % 10;
+        if(op < 6 || ids.empty())
+        {
+            if(u == ids.size() || v == ids.size() || ids[u] == G::null_vertex() || ids[v] == G::null_vertex())
+            {
+                u = add_vertex(g);
+                v = add_vertex(g);
+                ids.push_back(add_vertex(b));
+                ids.push_back(add_vertex(b));
+            }
+            if(add_edge(u, v, g).second)
+            {
+                add_edge(ids[u], ids[v], b);
+            }
+        }
+        else if(op < 8 && u < ids.size() && ids[u] != G::null_vertex())
+        {
+            typename G::adjacency_iterator p = adjacent_vertices(u, g).first;
+            if(p != adjacent_vertices(u, g).second)
+            {
+                remove_edge(ids[u], ids[*p], b);
+                remove_edge(u, *p, g);
+            }
+        }
+        else if(u < ids.size() && ids[u] != G::null_vertex())
+        {
+            clear_vertex(ids[u], b);
+            remove_vertex(ids[u], b);
+            remove_vertex(u, g);
+            for(std::size_t w = 0; w < ids.size(); ++w)
+            {
+                if(ids[w] != G::null_vertex() && ids[w] > ids[u])
+                {
+                    --ids[w];
+                }
+            }
+            ids[u] = G::null_vertex();
+        }
+        ASSERT_TRUE(num_vertices(g) == num_vertices(b));
+        ASSERT_TRUE(num_edges(g) == num_edges(b));
+    }
+    std::vector<std::size_t> remap = compact(g);
+    ASSERT_TRUE(remap == ids);
+    boost_graph::edge_iterator bb, be;
+    for(boost::tie(bb, be) = edges(b); bb != be; ++bb)
+    {
+        ASSERT_TRUE(edge(source(*bb, b), target(*bb, b), g).second);
+    }
+}
+
+TEST(TestGraphRemove, TEST_REORDER_REMOVED_1) 
+{
+    //the removed vertices are left out of the copy, as compact would
+    Graph g;
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+    add_edge(2, 3, g);
+    remove_vertex(1, g);
+    Reordering<Graph> r = reorder(g, reorder_bfs);
+    ASSERT_TRUE(num_vertices(r.graph) == 3);
+    ASSERT_TRUE(num_edges(r.graph) == 1);
+    ASSERT_TRUE(r.permutation.size() == 4);
+    ASSERT_TRUE(r.permutation[1] == Graph::null_vertex());
+    ASSERT_TRUE(r.inverse.size() == 3);
+    ASSERT_TRUE(edge(r.permutation[2], r.permutation[3], r.graph).second);
+}
+
+TEST(TestGraphRemove, TEST_MIXED_1) 
+{
+    check_mixed_removals<Graph>();
+    check_mixed_removals< basic_graph<small_vectorS<4>, vectorS> >();
+    check_mixed_removals< basic_graph<vectorS, vectorS, bidirectionalS> >();
+}
+
+// --------------
+// TestGraphStats
+// --------------
+
+TEST(TestGraphStats, TEST_STATS_1) 
+{
+    //the counters of one graph, built with and without -DGRAPH_STATS (the TestGraphStats target)
+    basic_graph<vectorS, vectorS> g;
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+    add_edge(0, 1, g);
+    ASSERT_FALSE(has_cycle(g));
+    vector<size_t> order;
+    topological_sort(g, back_inserter(order));
+    GraphStatsSnapshot s = graph_stats(g);
+#ifdef GRAPH_STATS
+    ASSERT_TRUE(s[op_add_edge].calls == 3);
+    ASSERT_TRUE(s[op_add_edge].bytes_allocated == 2 * sizeof(size_t));
+    ASSERT_TRUE(s[op_grow].calls == 2);
+    ASSERT_TRUE(s[op_grow].vertices_visited == 3);
+    ASSERT_TRUE(s[op_grow].bytes_allocated > 0);
+    ASSERT_TRUE(s[op_has_cycle].calls == 1);
+    ASSERT_TRUE(s[op_has_cycle].vertices_visited == 3);
+    ASSERT_TRUE(s[op_has_cycle].edges_examined == 2);
+    ASSERT_TRUE(s[op_topological_sort].calls == 1);
+    ASSERT_TRUE(s[op_topological_sort].vertices_visited == 3);
+    ASSERT_TRUE(s[op_topological_sort].edges_examined == 2);
+    ASSERT_TRUE(s[op_dfs_postorder].calls == 0); //counted as the operations that ran it
+    ASSERT_TRUE(dfs_postorder(g, discard_iterator()) == false);
+    ASSERT_TRUE(graph_stats(g)[op_dfs_postorder].calls == 1);
+    ASSERT_TRUE(graph_stats(g)[op_dfs_postorder].vertices_visited == 3);
+    size_t latencies = 0;
+    for(size_t b = 0; b < graph_stats_buckets; ++b)
+    {
+        latencies += s[op_add_edge].latency[b];
+    }
+    ASSERT_TRUE(latencies == 3);
+    ASSERT_TRUE(s[op_add_edge].percentile(0.5) <= s[op_add_edge].percentile(1.0));
+    ASSERT_TRUE(s[op_add_edge].percentile(1.0) > 0);
+
+    //a copy of the graph counts from zero, the original keeps its counts
+    basic_graph<vectorS, vectorS> h = g;
+    ASSERT_TRUE(graph_stats(h)[op_add_edge].calls == 0);
+    remove_vertex(1, h);
+    ASSERT_TRUE(graph_stats(h)[op_remove_vertex].calls == 1);
+    ASSERT_TRUE(graph_stats(h)[op_clear_vertex].edges_examined == 1);
+    ASSERT_TRUE(graph_stats(g)[op_remove_vertex].calls == 0);
+    reset_graph_stats(g);
+    ASSERT_TRUE(graph_stats(g)[op_add_edge].calls == 0);
+#else
+    for(size_t op = 0; op < op_count; ++op)
+    {
+        ASSERT_TRUE(s.ops[op].calls == 0);
+        ASSERT_TRUE(s.ops[op].nanoseconds == 0);
+        ASSERT_TRUE(s.ops[op].bytes_allocated == 0);
+    }
+#endif
+}
+
+TEST(TestGraphStats, TEST_STATS_2) 
+{
+    //graphs without counters of their own share one set per type
+    vector< pair<size_t, size_t> > edge_list;
+    edge_list.push_back(make_pair(0, 1));
+    edge_list.push_back(make_pair(1, 2));
+    edge_list.push_back(make_pair(2, 0));
+    CsrGraph a(edge_list.begin(), edge_list.end());
+    CsrGraph b;
+    reset_graph_stats(a);
+    vector<size_t> cycle;
+    ASSERT_TRUE(has_cycle(a, back_inserter(cycle)));
+    ASSERT_FALSE(has_cycle(b));
+    vector<size_t> component(3);
+    ASSERT_TRUE(strongly_connected_components(a, component.begin()) == 1);
+#ifdef GRAPH_STATS
+    ASSERT_TRUE(graph_stats(b)[op_has_cycle].calls == 2);
+    ASSERT_TRUE(graph_stats(b)[op_strongly_connected_components].vertices_visited == 3);
+    ASSERT_TRUE(graph_stats(b)[op_strongly_connected_components].edges_examined == 3);
+    ASSERT_TRUE(graph_stats(Graph())[op_has_cycle].calls == 0);
+#else
+    ASSERT_TRUE(graph_stats(b)[op_has_cycle].calls == 0);
+#endif
+}
+
+TEST(TestGraphStats, TEST_STATS_3) 
+{
+    //the snapshot printout, one line per operation called, and the latency buckets
+    GraphStats stats;
+    stats.record(op_add_edge, 1000, 0, 2, 8);
+    stats.record(op_add_edge, 0, 0, 1, 0);
+    GraphStatsSnapshot s = stats.snapshot();
+    ASSERT_TRUE(s[op_add_edge].latency[9] == 1);
+    ASSERT_TRUE(s[op_add_edge].latency[0] == 1);
+    ASSERT_TRUE(s[op_add_edge].percentile(0.5) == 2);
+    ASSERT_TRUE(s[op_add_edge].percentile(1.0) == 1024);
+    ostringstream w;
+    w << s;
+    ASSERT_TRUE(w.str() == "add_edge calls=2 mean_ns=500 p50_ns<=2 p99_ns<=1024 max_ns<=1024 vertices_visited=0 edges_examined=3 bytes_allocated=8\n");
+    stats.reset();
+    w.str("");
+    w << stats.snapshot();
+    ASSERT_TRUE(w.str() == "");
+}
+
+TEST(TestGraphStats, TEST_STATS_4) 
+{
+    //the periodic dump writes snapshots until it is destroyed, and nothing at all without GRAPH_STATS
+    Graph g;
+    add_edge(0, 1, g);
+    ostringstream w;
+    {
+        GraphStatsDump dump(g, w, std::chrono::milliseconds(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+#ifdef GRAPH_STATS
+    ASSERT_TRUE(w.str().find("add_edge calls=1 ") != string::npos);
+#else
+    ASSERT_TRUE(w.str() == "");
+#endif
+}
+
+// -------------------
+// TestConcurrentGraph
+// -------------------
+
+TEST(TestConcurrentGraph, TEST_CONCURRENT_1) 
+{
+    //a snapshot does not change when the writer goes on
+    ConcurrentGraph<> cg;
+    ASSERT_TRUE(num_vertices(*snapshot(cg)) == 0);
+    add_edge(0, 1, cg);
+    add_vertex(cg);
+    ConcurrentGraph<>::snapshot_type empty = snapshot(cg);
+    ASSERT_TRUE(num_edges(*empty) == 0);
+    ConcurrentGraph<>::snapshot_type s = publish(cg);
+    ASSERT_TRUE(snapshot(cg) == s);
+    add_edge(1, 2, cg);
+    ASSERT_TRUE(num_edges(*s) == 1);
+    ASSERT_TRUE(num_vertices(*s) == 3);
+    publish(cg);
+    ASSERT_TRUE(num_edges(*snapshot(cg)) == 2);
+    ASSERT_TRUE(num_edges(*s) == 1);
+    ASSERT_TRUE(num_edges(*empty) == 0);
+}
+
+TEST(TestConcurrentGraph, TEST_CONCURRENT_2) 
+{
+    //readers query snapshots while the writer grows a chain 10 edges at a time, every snapshot
+    //they see must be a whole batch, a DAG, and at least as new as the previous one
+    Graph start;
+    add_edge(0, 1, start);
+    ConcurrentGraph<> cg(start);
+    std::atomic<bool> done(false);
+    std::atomic<int> failures(0);
+    std::vector<std::thread> readers;
+    for(int r = 0; r < 4; ++r)
+    {
+        readers.push_back(std::thread([&cg, &done, &failures] ()
+        {
+            std::size_t last = 0;
+            while(!done.load())
+            {
+                ConcurrentGraph<>::snapshot_type s = snapshot(cg);
+                std::size_t m = num_edges(*s);
+                std::vector<std::size_t> order;
+                topological_sort(*s, std::back_inserter(order));
+                std::size_t degrees = 0;
+                for(std::size_t v = 0; v < num_vertices(*s); ++v)
+                {
+                    degrees += std::distance(adjacent_vertices(v, *s).first, adjacent_vertices(v, *s).second);
+                }
+                if(m < last || m % 10 != 1 || num_vertices(*s) != m + 1 || order.size() != m + 1 || degrees != m)
+                {
+                    ++failures;
+                }
+                last = m;
+            }
+        }));
+    }
+    for(std::size_t v = 1; v < 2001; ++v)
+    {
+        add_edge(v, v + 1, cg);
+        if(v % 10 == 0)
+        {
+            publish(cg);
+        }
+    }
+    done.store(true);
+    for(std::size_t r = 0; r < readers.size(); ++r)
+    {
+        readers[r].join();
+    }
+    ASSERT_TRUE(failures.load() == 0);
+    ASSERT_TRUE(num_edges(*snapshot(cg)) == 2001);
+}
+
+TEST(TestConcurrentGraph, TEST_CONCURRENT_3) 
+{
+    //publish builds the touched blocks and the new vertices again and shares the rest with the last snapshot
+    Graph mirror;
+    for(std::size_t v = 0; v + 1 < 1000; ++v)
+    {
+        add_edge(v, v + 1, mirror);
+    }
+    ConcurrentGraph<> cg(mirror);
+    ConcurrentGraph<>::snapshot_type s = snapshot(cg);
+    add_edge(0, 999, cg);
+    add_edge(0, 999, mirror);
+    add_edge(600, 2, cg);
+    add_edge(600, 2, mirror);
+    add_edge(1500, 3, cg);
+    add_edge(1500, 3, mirror);
+    ConcurrentGraph<>::snapshot_type t = publish(cg);
+    ASSERT_TRUE(&*adjacent_vertices(300, *s).first == &*adjacent_vertices(300, *t).first);
+    ASSERT_TRUE(&*adjacent_vertices(1, *s).first != &*adjacent_vertices(1, *t).first);
+    ASSERT_TRUE(num_edges(*s) == 999);
+    ASSERT_FALSE(edge(0, 999, *s).second);
+    ASSERT_TRUE(num_vertices(*t) == num_vertices(mirror));
+    ASSERT_TRUE(num_edges(*t) == num_edges(mirror));
+    ASSERT_TRUE(std::equal(edges(*t).first, edges(*t).second, edges(mirror).first));
+    add_vertex(cg);
+    add_vertex(mirror);
+    add_edge(1501, 0, cg);
+    add_edge(1501, 0, mirror);
+    t = publish(cg);
+    ASSERT_TRUE(num_vertices(*t) == num_vertices(mirror));
+    ASSERT_TRUE(num_edges(*t) == num_edges(mirror));
+    ASSERT_TRUE(std::equal(edges(*t).first, edges(*t).second, edges(mirror).first));
+}
+
+// ------------
+// TestColorMap
+// ------------
+
+TEST(TestColorMap, TEST_COLOR_MAP_1) 
+{
+    ColorMap colors(130);
+    ASSERT_TRUE(colors.is_white(129));
+    colors.set_grey(64);
+    ASSERT_TRUE(colors.is_grey(64));
+    ASSERT_FALSE(colors.is_white(64));
+    colors.set_black(64);
+    ASSERT_FALSE(colors.is_grey(64));
+    ASSERT_FALSE(colors.is_white(64));
+    ASSERT_TRUE(colors.is_white(63));
+    ASSERT_TRUE(colors.is_white(65));
+}
+
+TEST(TestColorMap, TEST_COLOR_MAP_2) 
+{
+    //the scan crosses whole visited words and stops at size()
+    ColorMap colors(130);
+    for(std::size_t v = 0; v < 130; ++v)
+    {
+        if(v != 5 && v != 128)
+        {
+            colors.set_black(v);
+        }
+    }
+    ASSERT_TRUE(colors.find_white(0) == 5);
+    ASSERT_TRUE(colors.find_white(5) == 5);
+    ASSERT_TRUE(colors.find_white(6) == 128);
+    ASSERT_TRUE(colors.find_white(129) == 130);
+    colors.set_grey(128);
+    ASSERT_TRUE(colors.find_white(6) == 130);
+    ASSERT_TRUE(colors.find_white(500) == 130);
+    ASSERT_TRUE(ColorMap(0).find_white(0) == 0);
+}
+
+TEST(TestColorMap, TEST_COLOR_MAP_3) 
+{
+    //roots past the first words, a back edge at the very end
+    Graph g;
+    for(std::size_t v = 0; v + 1 < 200; v += 2)
+    {
+        add_edge(v + 1, v, g);
+    }
+    ASSERT_FALSE(has_cycle(g));
+    std::vector<std::size_t> order;
+    topological_sort(g, std::back_inserter(order));
+    ASSERT_TRUE(is_topological(g, order));
+    add_edge(198, 199, g);
+    ASSERT_TRUE(has_cycle(g));
+}
+
+// ------------
+// TestCsrGraph
+// ------------
+
+TEST(TestCsrGraph, TEST_FROM_GRAPH_1) 
+{
+    Graph g;
+    add_edge(0, 3, g);
+    add_edge(0, 1, g);
+    add_edge(2, 0, g);
+    add_vertex(g);
+    CsrGraph c(g);
+    ASSERT_TRUE(num_vertices(c) == 5);
+    ASSERT_TRUE(num_edges(c) == 3);
+    std::pair<CsrGraph::adjacency_iterator, CsrGraph::adjacency_iterator> p = adjacent_vertices(0, c);
+    ASSERT_TRUE(std::distance(p.first, p.second) == 2);
+    ASSERT_TRUE(*p.first == 1);
+    ASSERT_TRUE(edge(2, 0, c).second);
+    ASSERT_TRUE(adjacent_vertices(4, c).first == adjacent_vertices(4, c).second);
+}
+
+TEST(TestCsrGraph, TEST_FROM_EDGE_LIST_1) 
+{
+    //unsorted, with a duplicate, and a vertex count larger than the edges need
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    el.push_back(std::make_pair(3, 1));
+    el.push_back(std::make_pair(0, 2));
+    el.push_back(std::make_pair(3, 0));
+    el.push_back(std::make_pair(0, 2));
+    CsrGraph c(el.begin(), el.end(), 6);
+    ASSERT_TRUE(num_vertices(c) == 6);
+    ASSERT_TRUE(num_edges(c) == 3);
+    std::ostringstream out;
+    for(CsrGraph::edge_iterator b = edges(c).first; b != edges(c).second; ++b)
+    {
+        out << source(*b, c) << "-" << target(*b, c) << " ";
+    }
+    ASSERT_TRUE(out.str() == "0-2 3-0 3-1 ");
+}
+
+TEST(TestCsrGraph, TEST_FROM_EDGE_LIST_2) 
+{
+    //same edges as a Graph built with add_edge, same CsrGraph
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    Graph g;
+    for(std::size_t i = 0; i < 50; ++i)
+    {
+        el.push_back(std::make_pair((i * 7) % 13, (i * 11) % 17));
+        add_edge((i * 7) % 13, (i * 11) % 17, g);
+    }
+    ASSERT_TRUE(CsrGraph(el.begin(), el.end()) == CsrGraph(g));
+}
+
+TEST(TestCsrGraph, TEST_TOPOLOGICAL_SORT_1) 
+{
+    Graph g;
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+    add_edge(0, 2, g);
+    std::ostringstream out;
+    topological_sort(CsrGraph(g), std::ostream_iterator<std::size_t>(out, " "));
+    ASSERT_TRUE(out.str() == "2 1 0 ");
+    add_edge(2, 0, g);
+    ASSERT_TRUE(has_cycle(CsrGraph(g)));
+}
+
+// -------------------
+// TestCompressedGraph
+// -------------------
+
+TEST(TestCompressedGraph, TEST_COMPRESSED_1) 
+{
+    //neighbours before and after their source, far and near, and empty rows
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    el.push_back(std::make_pair(5, 0));
+    el.push_back(std::make_pair(5, 4));
+    el.push_back(std::make_pair(5, 6));
+    el.push_back(std::make_pair(5, 300));
+    el.push_back(std::make_pair(5, 301));
+    el.push_back(std::make_pair(300, 5));
+    el.push_back(std::make_pair(0, 1));
+    el.push_back(std::make_pair(0, 1));
+    Graph g(el.begin(), el.end());
+    CompressedGraph c(g);
+    ASSERT_TRUE(num_vertices(c) == 302);
+    ASSERT_TRUE(num_edges(c) == 7);
+    ostringstream out;
+    std::copy(adjacent_vertices(5, c).first, adjacent_vertices(5, c).second, std::ostream_iterator<std::size_t>(out, " "));
+    ASSERT_TRUE(out.str() == "0 4 6 300 301 ");
+    ASSERT_TRUE(adjacent_vertices(1, c).first == adjacent_vertices(1, c).second);
+    ASSERT_TRUE(edge(300, 5, c).second);
+    ASSERT_FALSE(edge(5, 7, c).second);
+    ASSERT_FALSE(edge(400, 5, c).second);
+    ASSERT_TRUE(std::equal(edges(g).first, edges(g).second, edges(c).first));
+    ASSERT_TRUE(std::distance(edges(c).first, edges(c).second) == 7);
+    ASSERT_TRUE(has_cycle(c));
+    ASSERT_TRUE(c == CompressedGraph(el.begin(), el.end()));
+    ASSERT_TRUE(c == CompressedGraph(CsrGraph(g)));
+}
+
+TEST(TestCompressedGraph, TEST_COMPRESSED_2) 
+{
+    //7 bits per byte, up to the 10 bytes of a 64 bit value
+    std::size_t values[] = {0, 127, 128, (std::size_t(1) << 41) + 3, ~std::size_t(0)};
+    std::size_t sizes[] = {1, 1, 2, 6, 10};
+    for(std::size_t i = 0; i < 5; ++i)
+    {
+        std::vector<std::uint8_t> bytes;
+        encode_varint(values[i], bytes);
+        ASSERT_TRUE(bytes.size() == sizes[i]);
+        const std::uint8_t* p = bytes.data();
+        ASSERT_TRUE(decode_varint(p) == values[i]);
+        ASSERT_TRUE(p == bytes.data() + bytes.size());
+    }
+    ASSERT_TRUE(num_vertices(CompressedGraph()) == 0);
+    ASSERT_TRUE(num_edges(CompressedGraph()) == 0);
+}
+
+TEST(TestCompressedGraph, TEST_COMPRESSED_3) 
+{
+    //same traversals as the Graph it was encoded from
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    std::size_t seed = 3;
+    for(std::size_t i = 0; i < 2000; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::size_t u = (seed >> 33) % 500;
+        std::size_t v = (seed >> 13) % 500;
+        if(u != v)
+        {
+            el.push_back(std::make_pair(std::min(u, v), std::max(u, v)));
+        }
+    }
+    basic_graph<vectorS, vectorS> g(el.begin(), el.end());
+    CompressedGraph c(g);
+    ASSERT_FALSE(has_cycle(c));
+    std::vector<std::size_t> expected;
+    std::vector<std::size_t> order;
+    topological_sort(g, std::back_inserter(expected));
+    topological_sort(c, std::back_inserter(order));
+    ASSERT_TRUE(order == expected);
+    ASSERT_TRUE(bytes(c) < num_edges(c) * sizeof(std::size_t));
+}
+
+// ---------------
+// TestStaticGraph
+// ---------------
+
+//the fixture's graph, with its cycle D -> F -> D, and the inputs of TEST_TOPOLOGICAL_SORT_2 and _3, all built by the compiler
+constexpr StaticGraph<8, 11> static_fixture({{0, 1}, {0, 2}, {0, 4}, {1, 3}, {1, 4}, {2, 3}, {3, 4}, {3, 5}, {5, 3}, {5, 7}, {6, 7}});
+constexpr StaticGraph<5, 4> static_chain({{0, 1}, {1, 2}, {2, 3}, {3, 4}});
+constexpr StaticGraph<4, 4> static_diamond({{0, 1}, {0, 2}, {1, 3}, {2, 3}});
+
+static_assert(num_vertices(static_fixture) == 8 && num_edges(static_fixture) == 11, "the fixture's size");
+static_assert(edge(5, 3, static_fixture).second && !edge(6, 5, static_fixture).second, "the fixture's edges");
+static_assert(!edge(8, 0, static_fixture).second && !edge(4, 0, static_diamond).second && !edge(100, 0, static_chain).second, "no edge out of a vertex past num_vertices or MaxV");
+static_assert(has_cycle(static_fixture), "D -> F -> D");
+static_assert(!has_cycle(static_chain) && !has_cycle(static_diamond), "DAGs");
+
+constexpr StaticOrder<5> static_chain_order = topological_order(static_chain);
+constexpr StaticOrder<4> static_diamond_order = topological_order(static_diamond);
+static_assert(static_chain_order.size == 5 && static_chain_order[0] == 4 && static_chain_order[4] == 0, "4 3 2 1 0, as TEST_TOPOLOGICAL_SORT_2");
+static_assert(static_diamond_order[0] == 3 && static_diamond_order[1] == 1 && static_diamond_order[2] == 2 && static_diamond_order[3] == 0, "3 1 2 0, as TEST_TOPOLOGICAL_SORT_3");
+
+/**
+ * the same edges into a Graph and a StaticGraph, and the same answers from both
+ */
+template <std::size_t V, std::size_t E>
+void check_static_matches (const StaticGraph<V, E>& sg, const vector< pair<size_t, size_t> >& edge_list)
+{
+    Graph g;
+    for(size_t i = 0; i < edge_list.size(); ++i)
+    {
+        add_edge(edge_list[i].first, edge_list[i].second, g);
+    }
+    ASSERT_TRUE(num_vertices(sg) == num_vertices(g));
+    ASSERT_TRUE(num_edges(sg) == num_edges(g));
+    for(size_t v = 0; v < num_vertices(g); ++v)
+    {
+        ASSERT_TRUE(equal(adjacent_vertices(v, g).first, adjacent_vertices(v, g).second, adjacent_vertices(v, sg).first));
+    }
+    ASSERT_TRUE(has_cycle(sg) == has_cycle(g));
+    vector<size_t> expected;
+    vector<size_t> order;
+    if(has_cycle(g))
+    {
+        ASSERT_THROW(topological_sort(sg, back_inserter(order)), not_a_dag);
+        ASSERT_TRUE(order.empty());
+    }
+    else
+    {
+        topological_sort(g, back_inserter(expected));
+        topological_sort(sg, back_inserter(order));
+        ASSERT_TRUE(order == expected);
+    }
+}
+
+TEST(TestStaticGraph, TEST_STATIC_1) 
+{
+    //the compile-time graphs, queried at run time, against Graph
+    vector< pair<size_t, size_t> > fixture = {{0, 1}, {0, 2}, {0, 4}, {1, 3}, {1, 4}, {2, 3}, {3, 4}, {3, 5}, {5, 3}, {5, 7}, {6, 7}};
+    check_static_matches(static_fixture, fixture);
+    check_static_matches(static_chain, {{0, 1}, {1, 2}, {2, 3}, {3, 4}});
+    check_static_matches(static_diamond, {{0, 1}, {0, 2}, {1, 3}, {2, 3}});
+    ASSERT_TRUE(vector<size_t>(static_diamond_order.begin(), static_diamond_order.end()) == vector<size_t>({3, 1, 2, 0}));
+}
+
+TEST(TestStaticGraph, TEST_STATIC_2) 
+{
+    //random edges with duplicates, forward only and then with some reversed, added at run time
+    size_t n = 200;
+    for(size_t every = 0; every <= 7; every += 7)
+    {
+        StaticGraph<200, 600> sg;
+        vector< pair<size_t, size_t> > edge_list;
+        size_t seed = 11;
+        for(size_t i = 0; i < 600; ++i)
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            size_t u = std::min((seed >> 33) % n, (seed >> 13) % n);
+            size_t v = std::max((seed >> 33) % n, (seed >> 13) % n);
+            if(u == v)
+            {
+                continue;
+            }
+            if(every != 0 && i % every == 0)
+            {
+                std::swap(u, v);
+            }
+            edge_list.push_back(make_pair(u, v));
+            add_edge(u, v, sg);
+        }
+        check_static_matches(sg, edge_list);
+    }
+}
+
+TEST(TestStaticGraph, TEST_STATIC_3) 
+{
+    //the capacity, a throw at run time and a compile error in a constant expression
+    StaticGraph<3, 2> sg;
+    ASSERT_TRUE(add_vertex(sg) == 0);
+    ASSERT_TRUE(add_edge(0, 1, sg).second);
+    ASSERT_FALSE(add_edge(0, 1, sg).second);
+    ASSERT_TRUE(add_edge(1, 2, sg).second);
+    ASSERT_TRUE(num_vertices(sg) == 3);
+    ASSERT_THROW(add_edge(2, 0, sg), std::length_error);
+    ASSERT_THROW(add_edge(0, 3, sg), std::length_error);
+    ASSERT_THROW(add_vertex(sg), std::length_error);
+    ASSERT_TRUE(num_edges(sg) == 2);
+}
+
+// ------------
+// TestGraphScc
+// ------------
+
+TEST(TestGraphScc, TEST_SCC_1) 
+{
+    //the same partition as boost, serial and parallel, on the row-based, CSR and compressed graphs
+    typedef adjacency_list<vecS, vecS, directedS> boost_graph;
+    std::size_t n = 5000;
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    std::size_t seed = 11;
+    for(std::size_t i = 0; i < 2 * n; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::size_t u = (seed >> 33) % n;
+        std::size_t v = (seed >> 13) % n;
+        el.push_back(i % 3 == 0 ? std::make_pair(std::max(u, v), std::min(u, v)) : std::make_pair(std::min(u, v), std::max(u, v)));
+    }
+    for(std::size_t i = 1; i < 100; ++i)
+    {
+        el.push_back(std::make_pair(i - 1, i)); //one long cycle
+    }
+    el.push_back(std::make_pair(99, 0));
+    el.push_back(std::make_pair(n - 1, n - 1)); //and a self loop on the last vertex
+    boost_graph b(el.begin(), el.end(), n);
+    std::vector<std::size_t> expected(n);
+    std::size_t count = strong_components(b, make_iterator_property_map(expected.begin(), get(vertex_index, b)));
+    Graph g(el.begin(), el.end());
+    CsrGraph csr(g);
+    CompressedGraph c(g);
+    ASSERT_TRUE(num_vertices(g) == n);
+    std::vector<std::size_t> component(n);
+    ASSERT_TRUE(strongly_connected_components(g, component.begin()) == count);
+    ASSERT_TRUE(same_partition(component, expected));
+    ASSERT_TRUE(parallel_strongly_connected_components(g, component.begin(), 3) == count);
+    ASSERT_TRUE(same_partition(component, expected));
+    ASSERT_TRUE(strongly_connected_components(csr, component.begin()) == count);
+    ASSERT_TRUE(same_partition(component, expected));
+    ASSERT_TRUE(parallel_strongly_connected_components(csr, component.begin(), 4) == count);
+    ASSERT_TRUE(same_partition(component, expected));
+    ASSERT_TRUE(strongly_connected_components(c, component.begin()) == count);
+    ASSERT_TRUE(same_partition(component, expected));
+    ASSERT_TRUE(parallel_strongly_connected_components(c, component.begin(), 2) == count);
+    ASSERT_TRUE(same_partition(component, expected));
+    std::vector<std::size_t> cycle;
+    ASSERT_TRUE(has_cycle(c, std::back_inserter(cycle)));
+    for(std::size_t i = 0; i < cycle.size(); ++i)
+    {
+        ASSERT_TRUE(edge(cycle[i], cycle[(i + 1) % cycle.size()], c).second);
+        ASSERT_TRUE(component[cycle[i]] == component[cycle[0]]);
+    }
+}
+
+TEST(TestGraphScc, TEST_SCC_2) 
+{
+    //a DAG is trimmed away entirely, one component per vertex
+    std::vector< std::pair<std::size_t, std::size_t> > el;
+    for(std::size_t i = 0; i < 1000; ++i)
+    {
+        el.push_back(std::make_pair(i / 2, i + 1));
+    }
+    CsrGraph g(el.begin(), el.end());
+    std::vector<std::size_t> component(num_vertices(g));
+    ASSERT_TRUE(parallel_strongly_connected_components(g, component.begin(), 4) == num_vertices(g));
+    std::sort(component.begin(), component.end());
+    for(std::size_t v = 0; v < component.size(); ++v)
+    {
+        ASSERT_TRUE(component[v] == v);
+    }
+    std::vector<std::size_t> cycle;
+    ASSERT_FALSE(has_cycle(g, std::back_inserter(cycle)));
+    ASSERT_TRUE(cycle.empty());
+}
+
+// -------------
+// TestGraphFile
+// -------------
+
+TEST(TestGraphFile, TEST_ROUND_TRIP_1) 
+{
+    Graph g;
+    add_edge(0, 1, g);
+    add_edge(0, 2, g);
+    add_edge(1, 3, g);
+    add_edge(2, 3, g);
+    add_edge(5, 4, g);
+    add_vertex(g);
+    save_graph(g, "TestGraph.tmp.graph");
+    {
+        MappedGraph m("TestGraph.tmp.graph");
+        ASSERT_TRUE(num_vertices(m) == 7);
+        ASSERT_TRUE(num_edges(m) == 5);
+        CsrGraph c(g);
+        ASSERT_TRUE(std::equal(edges(m).first, edges(m).second, edges(c).first));
+        ASSERT_TRUE(edge(5, 4, m).second);
+        ASSERT_FALSE(edge(4, 5, m).second);
+        ASSERT_FALSE(has_cycle(m));
+        std::ostringstream out;
+        topological_sort(m, std::ostream_iterator<std::size_t>(out, " "));
+        ASSERT_TRUE(out.str() == "3 1 2 0 4 5 6 ");
+    }
+    std::remove("TestGraph.tmp.graph");
+}
+
+TEST(TestGraphFile, TEST_ROUND_TRIP_2) 
+{
+    //empty graph
+    save_graph(Graph(), "TestGraph.tmp.graph");
+    {
+        MappedGraph m("TestGraph.tmp.graph");
+        ASSERT_TRUE(num_vertices(m) == 0);
+        ASSERT_TRUE(edges(m).first == edges(m).second);
+        ASSERT_FALSE(has_cycle(m));
+    }
+    std::remove("TestGraph.tmp.graph");
+}
+
+TEST(TestGraphFile, TEST_VALIDATE_1) 
+{
+    //a flipped bit in the targets, a wrong version, a truncated file
+    Graph g;
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+    save_graph(g, "TestGraph.tmp.graph");
+    std::fstream f("TestGraph.tmp.graph", std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(sizeof(GraphFileHeader) + 4 * sizeof(std::size_t));
+    f.put(7);
+    f.close();
+    ASSERT_THROW(MappedGraph m("TestGraph.tmp.graph"), GraphFileError);
+    ASSERT_THROW(MappedGraph m("TestGraph.tmp.graph", false), GraphFileError); //7 is not a vertex
+
+    save_graph(g, "TestGraph.tmp.graph");
+    f.open("TestGraph.tmp.graph", std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(sizeof(GraphFileHeader) + 4 * sizeof(std::size_t));
+    f.put(2);
+    f.close();
+    ASSERT_THROW(MappedGraph m("TestGraph.tmp.graph"), GraphFileError);
+    ASSERT_NO_THROW(MappedGraph m("TestGraph.tmp.graph", false)); //0 -> 2 instead of 0 -> 1, still a graph
+
+    save_graph(g, "TestGraph.tmp.graph");
+    f.open("TestGraph.tmp.graph", std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(8);
+    f.put(9);
+    f.close();
+    ASSERT_THROW(MappedGraph m("TestGraph.tmp.graph"), GraphFileError);
+
+    std::ofstream("TestGraph.tmp.graph", std::ios::binary | std::ios::trunc) << "GRAPHCSR";
+    ASSERT_THROW(MappedGraph m("TestGraph.tmp.graph"), GraphFileError);
+    std::remove("TestGraph.tmp.graph");
+    ASSERT_THROW(MappedGraph m("TestGraph.tmp.graph"), GraphFileError);
+}
+
+TEST(TestGraphFile, TEST_VALIDATE_2) 
+{
+    //offsets that decrease, a file from a machine of the other byte order
+    Graph g;
+    add_edge(0, 1, g);
+    add_edge(1, 2, g);
+    save_graph(g, "TestGraph.tmp.graph");
+    std::fstream f("TestGraph.tmp.graph", std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(sizeof(GraphFileHeader) + sizeof(std::size_t));
+    f.put(3);
+    f.close();
+    ASSERT_THROW(MappedGraph m("TestGraph.tmp.graph"), GraphFileError);
+    ASSERT_THROW(MappedGraph m("TestGraph.tmp.graph", false), GraphFileError);
+
+    save_graph(g, "TestGraph.tmp.graph");
+    const std::uint64_t swapped = 0x0807060504030201ULL;
+    f.open("TestGraph.tmp.graph", std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(offsetof(GraphFileHeader, byte_order));
+    f.write(reinterpret_cast<const char*>(&swapped), sizeof(swapped));
+    f.close();
+    ASSERT_THROW(MappedGraph m("TestGraph.tmp.graph", false), GraphFileError);
+
+    //a target past the vertices with a checksum that matches it, as a faulty writer would produce
+    save_graph(g, "TestGraph.tmp.graph");
+    std::ifstream in("TestGraph.tmp.graph", std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    GraphFileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    std::vector<std::uint64_t> words((bytes.size() - sizeof(header)) / sizeof(std::uint64_t));
+    std::memcpy(words.data(), bytes.data() + sizeof(header), words.size() * sizeof(std::uint64_t));
+    words[4] = 7;
+    header.checksum = graph_file_checksum(graph_file_checksum_seed, words.data(), words.data() + words.size());
+    std::ofstream out("TestGraph.tmp.graph", std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(std::uint64_t));
+    out.close();
+    ASSERT_THROW(MappedGraph m("TestGraph.tmp.graph"), GraphFileError);
+    std::remove("TestGraph.tmp.graph");
+}
+
+// ---------------
+// TestGraphLoader
+// ---------------
+
+TEST(TestGraphLoader, TEST_PARSE_EDGE_LINE_1) 
+{
+    std::pair<std::size_t, std::size_t> e;
+    std::string lines[] = {"3 4", "  12\t7 \r", "", "# comment", "3", "3 x", "34", "3 4 5", "-1 2", "99999999999999999999 1"};
+    int expected[] = {1, 1, 0, 0, -1, -1, -1, -1, -1, -1};
+    for(std::size_t i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(parse_edge_line(lines[i].data(), lines[i].data() + lines[i].size(), e) == expected[i]);
+        if(i == 1)
+        {
+            ASSERT_TRUE(e.first == 12 && e.second == 7);
+        }
+    }
+}
+
+TEST(TestGraphLoader, TEST_READ_EDGE_LIST_1) 
+{
+    //blocks much smaller than the file, several threads, malformed lines reported by offset
+    std::ostringstream text;
+    Graph expected;
+    std::vector<std::size_t> bad;
+    for(std::size_t i = 0; i < 3000; ++i)
+    {
+        if(i % 500 == 7)
+        {
+            bad.push_back(text.str().size());
+            text << i << " oops\n";
+        }
+        else
+        {
+            text << (i * 37) % 211 << " " << (i * 53) % 199 << "\n";
+            add_edge((i * 37) % 211, (i * 53) % 199, expected);
+        }
+    }
+    text << "5 6"; //no newline at the end of the file
+    add_edge(5, 6, expected);
+    std::ofstream("TestGraph.tmp.txt", std::ios::binary) << text.str();
+
+    EdgeListOptions options;
+    options.block_size = 1000;
+    options.threads = 3;
+    Graph g;
+    EdgeListReport report = read_edge_list("TestGraph.tmp.txt", g, options);
+    std::remove("TestGraph.tmp.txt");
+    ASSERT_TRUE(g == expected);
+    ASSERT_TRUE(report.bytes == text.str().size());
+    ASSERT_TRUE(report.lines == 3000 - bad.size() + 1);
+    ASSERT_TRUE(report.malformed == bad.size());
+    ASSERT_TRUE(report.offsets == bad);
+}
+
+TEST(TestGraphLoader, TEST_READ_EDGE_LIST_2) 
+{
+    Graph g;
+    ASSERT_THROW(read_edge_list("TestGraph.tmp.missing", g), std::runtime_error);
+    std::ofstream("TestGraph.tmp.txt", std::ios::binary) << "1 2\n" << std::string(100, '1') << " 2\n";
+    EdgeListOptions options;
+    options.block_size = 50;
+    ASSERT_THROW(read_edge_list("TestGraph.tmp.txt", g, options), std::runtime_error);
+    std::remove("TestGraph.tmp.txt");
+}
+
+//a graph whose add_edges always fails, as on bad_alloc
+struct FailingGraph
+{
+    friend std::size_t num_vertices (const FailingGraph&)
+    {
+        return 0;
+    }
+
+    template <typename FI>
+    friend std::size_t add_edges (FailingGraph&, FI, FI)
+    {
+        throw std::bad_alloc();
+    }
+};
+
+TEST(TestGraphLoader, TEST_READ_EDGE_LIST_3) 
+{
+    //an exception out of add_edges closes the file and joins the parsing threads
+    std::ofstream("TestGraph.tmp.txt", std::ios::binary) << "1 2\n3 4\n5 6\n";
+    EdgeListOptions options;
+    options.threads = 3;
+    int fd = ::open("/dev/null", O_RDONLY); //the lowest free descriptor, a leaked one would push it up
+    ::close(fd);
+    for(std::size_t i = 0; i < 20; ++i)
+    {
+        FailingGraph g;
+        ASSERT_THROW(read_edge_list("TestGraph.tmp.txt", g, options), std::bad_alloc);
+    }
+    std::remove("TestGraph.tmp.txt");
+    int after = ::open("/dev/null", O_RDONLY);
+    ::close(after);
+    ASSERT_TRUE(after == fd);
+}
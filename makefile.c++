@@ -5,6 +5,11 @@ clean:
 	rm -f Graph.log
 	rm -f Graph.zip
 	rm -f TestGraph
+	rm -f BenchGraph
+	rm -f TestGraphStats
+	rm -f BenchGraphStats
+	rm -f BenchGraph.json
+	rm -f BenchGraphFull.json
 
 doc: Graph.h
 	doxygen Doxyfile
@@ -21,11 +26,26 @@ turnin-verify:
 Graph.log:
 	git log > Graph.log
 
-Graph.zip:                 Graph.h Graph.log TestGraph.c++ TestGraph.out
-	zip -r Graph.zip html/ Graph.h Graph.log TestGraph.c++ TestGraph.out
+Graph.zip:                 Graph.h GraphArena.h GraphCompressed.h GraphConcurrent.h GraphFile.h GraphLoader.h GraphStatic.h GraphStats.h Graph.log TestGraph.c++ TestGraph.out BenchGraph.c++
+	zip -r Graph.zip html/ Graph.h GraphArena.h GraphCompressed.h GraphConcurrent.h GraphFile.h GraphLoader.h GraphStatic.h GraphStats.h Graph.log TestGraph.c++ TestGraph.out BenchGraph.c++
 
-TestGraph: Graph.h TestGraph.c++
-	g++ -pedantic -std=c++0x -Wall TestGraph.c++ -o TestGraph -lgtest -lgtest_main -pthread
+TestGraph: Graph.h GraphArena.h GraphCompressed.h GraphConcurrent.h GraphFile.h GraphLoader.h GraphStatic.h GraphStats.h TestGraph.c++
+	g++ -pedantic -std=c++14 -Wall TestGraph.c++ -o TestGraph -lgtest -lgtest_main -pthread
+
+BenchGraph: Graph.h GraphArena.h GraphCompressed.h GraphConcurrent.h GraphFile.h GraphLoader.h GraphStatic.h GraphStats.h BenchGraph.c++
+	g++ -pedantic -std=c++14 -Wall -O3 BenchGraph.c++ -o BenchGraph -lbenchmark -pthread
+
+TestGraphStats: Graph.h GraphArena.h GraphCompressed.h GraphConcurrent.h GraphFile.h GraphLoader.h GraphStatic.h GraphStats.h TestGraph.c++
+	g++ -pedantic -std=c++14 -Wall -DGRAPH_STATS TestGraph.c++ -o TestGraphStats -lgtest -lgtest_main -pthread
+
+BenchGraphStats: Graph.h GraphArena.h GraphCompressed.h GraphConcurrent.h GraphFile.h GraphLoader.h GraphStatic.h GraphStats.h BenchGraph.c++
+	g++ -pedantic -std=c++14 -Wall -O3 -DGRAPH_STATS BenchGraph.c++ -o BenchGraphStats -lbenchmark -pthread
+
+BenchGraph.json: BenchGraph
+	./BenchGraph --benchmark_out=BenchGraph.json --benchmark_out_format=json
+
+BenchGraphFull.json: BenchGraph
+	BENCH_GRAPH_MAX_EDGES=10000000 ./BenchGraph --benchmark_out=BenchGraphFull.json --benchmark_out_format=json
 
 TestGraph.out: TestGraph
 	valgrind TestGraph > TestGraph.out